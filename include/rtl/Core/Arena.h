@@ -0,0 +1,66 @@
+#ifndef RTL_CORE_ARENA_H
+#define RTL_CORE_ARENA_H
+
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace rtl {
+    namespace core {
+        // Bump allocator: memory comes out of big blocks and is only given back when the arena dies.
+        // allocate() and copy() hand out raw memory; objects built with make() are destroyed along with the arena, newest first.
+        class Arena {
+        private:
+            struct Finalizer {
+                Finalizer *next;
+                void *object;
+                void (*destroy)(void *object);
+            };
+
+            std::vector<std::unique_ptr<char[]>> blocks;
+            Finalizer *finalizers = nullptr; // Intrusive list living in the arena itself.
+
+            char *cursor = nullptr;
+            char *limit = nullptr;
+
+            std::size_t blockSize;
+        public:
+            Arena(std::size_t blockSize = 64 * 1024);
+            ~Arena();
+
+            Arena(const Arena &) = delete;
+            Arena &operator=(const Arena &) = delete;
+
+            void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+            // Copies `text` into the arena; the result is NOT null-terminated.
+            std::string_view copy(const std::string_view &text);
+
+            // Takes over everything `other` has handed out, which then lives (and is destroyed) with this arena. `other` is left empty.
+            void absorb(Arena &&other);
+
+            template<typename T, typename... Args>
+            T *make(Args &&...args) {
+                T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    auto finalizer = (Finalizer *)allocate(sizeof(Finalizer), alignof(Finalizer));
+                    finalizer->next = finalizers;
+                    finalizer->object = object;
+                    finalizer->destroy = [](void *object) { ((T *)object)->~T(); };
+
+                    finalizers = finalizer;
+                }
+
+                return object;
+            }
+        };
+    }
+}
+
+#endif /* RTL_CORE_ARENA_H */
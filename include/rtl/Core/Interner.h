@@ -0,0 +1,55 @@
+#ifndef RTL_CORE_INTERNER_H
+#define RTL_CORE_INTERNER_H
+
+#include "rtl/Core/Arena.h"
+
+#include <array>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtl {
+    namespace core {
+        // ID of an interned string; two names are the same iff their symbols are. 0 is never handed out.
+        // The low bits say which of the interner's shards the string is in and the rest are its index there, so symbols are dense per shard rather than overall.
+        using Symbol = std::uint32_t;
+
+        // Maps every distinct string to a Symbol and keeps one copy of it in an arena.
+        // Safe to use from several threads at once: a string's hash picks the shard it lives in, and each shard has its own lock,
+        // so parser threads interning different names rarely wait on each other.
+        class Interner {
+        private:
+            static constexpr unsigned shardBits = 4;
+            static constexpr std::size_t shardCount = (std::size_t)1 << shardBits;
+
+            struct Shard {
+                mutable std::shared_mutex mutex;
+
+                Arena arena;
+                std::unordered_map<std::string_view, Symbol> symbols; // Keys point into the arena.
+                std::vector<std::string_view> strings; // Indexed by symbol >> shardBits.
+            };
+
+            std::array<Shard, shardCount> shards;
+        public:
+            Interner();
+
+            Interner(const Interner &) = delete;
+            Interner &operator=(const Interner &) = delete;
+
+            Symbol intern(const std::string_view &text);
+            std::string_view get(Symbol symbol) const;
+
+            std::size_t size() const;
+
+            // The interner the parser puts names in.
+            static Interner &global();
+        };
+    }
+}
+
+#endif /* RTL_CORE_INTERNER_H */
@@ -0,0 +1,26 @@
+#ifndef RTL_CORE_SCAN_H
+#define RTL_CORE_SCAN_H
+
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtl {
+    namespace core {
+        // Bulk scanners for the lexer. They look at 32 (AVX2) or 16 (SSE2) bytes at a time, picking the widest the CPU supports on first use, and fall back to plain loops elsewhere.
+        // Each returns the offset it stopped at, or source.size() if it ran off the end.
+
+        // Skips ' ', '\t', '\n', '\v', '\f' and '\r' starting at `from`.
+        std::size_t skipBlanks(const std::string_view &source, std::size_t from);
+
+        // Finds the first `a` or `b` at or after `from`.
+        std::size_t findEither(const std::string_view &source, std::size_t from, char a, char b);
+
+        // Appends the offset of the first byte of every line (0, then one past each '\n') to `lineStarts`.
+        void collectLineStarts(const std::string_view &source, std::vector<std::uint32_t> &lineStarts);
+    }
+}
+
+#endif /* RTL_CORE_SCAN_H */
@@ -0,0 +1,67 @@
+#ifndef RTL_CORE_SOURCE_BUFFER_H
+#define RTL_CORE_SOURCE_BUFFER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rtl/Core/SourceLocation.h"
+
+namespace rtl {
+    namespace core {
+        struct LineColumn {
+            std::uint32_t line, column; // Both start at 1.
+        };
+
+        // Owns the bytes of one source file. Files are memory-mapped when we can (regular files on POSIX), otherwise they're read in a single pass (pipes, /dev/stdin, Windows).
+        // Every buffer is registered with the SourceManager when it's created and stays alive until the program exits, since tokens, SourceLocations and core::Error all refer back to it.
+        class SourceBuffer {
+        private:
+            friend class SourceManager;
+
+            std::string name;
+            std::uint32_t base = 0; // Position of the first byte; see SourceManager.
+
+            const char *data = nullptr;
+            std::size_t size = 0;
+
+            bool mapped = false;
+            std::string contents; // Only used when the file isn't mapped.
+
+            mutable std::once_flag lineStartsOnce;
+            mutable std::vector<std::uint32_t> lineStarts;
+
+            SourceBuffer(const std::string &name);
+        public:
+            SourceBuffer(const std::string &name, std::string &&contents);
+            ~SourceBuffer();
+
+            SourceBuffer(const SourceBuffer &) = delete;
+            SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+            static std::shared_ptr<SourceBuffer> fromFile(const std::string &filepath);
+            static std::shared_ptr<SourceBuffer> fromSource(const std::string &name, const std::string_view &source);
+
+            const std::string &getName() const;
+            std::string_view getSource() const;
+            bool isMapped() const;
+
+            std::uint32_t getBase() const;
+            SourceLocation getLocation(std::uint32_t offset) const;
+            std::uint32_t getOffset(SourceLocation location) const; // 'location' has to be in this file.
+
+            // Offsets of the first byte of every line, built on first use (i.e. usually when the first diagnostic is printed).
+            const std::vector<std::uint32_t> &getLineStarts() const;
+
+            LineColumn getLineColumn(std::uint32_t offset) const;
+            std::string_view getLine(std::uint32_t line) const; // Without the '\n'.
+        };
+    }
+}
+
+#endif /* RTL_CORE_SOURCE_BUFFER_H */
@@ -7,18 +7,18 @@
 
 namespace rtl {
     namespace core {
+        // Just where a byte is, as a position in SourceManager's space; the file, line and column are worked out from it only when something actually gets printed.
         struct SourceLocation {
-            std::string_view source;
-            std::string_view moduleName;
-            std::size_t pointer;
-            std::uint32_t line, lexpos;
+            std::uint32_t position = 0; // 0 means we don't know where.
 
             SourceLocation() = default;
-            SourceLocation(const std::string_view &moduleName, std::size_t pointer, std::uint32_t line, std::uint32_t lexpos);
+            explicit SourceLocation(std::uint32_t position);
+
+            bool isValid() const;
 
             std::string getFormatted() const;
         };
     }
 }
 
-#endif /* RTL_PARSER_SOURCE_LOCATION_H */
\ No newline at end of file
+#endif /* RTL_PARSER_SOURCE_LOCATION_H */
@@ -0,0 +1,47 @@
+#ifndef RTL_CORE_SOURCE_MANAGER_H
+#define RTL_CORE_SOURCE_MANAGER_H
+
+#include "rtl/Core/SourceBuffer.h"
+#include "rtl/Core/SourceLocation.h"
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtl {
+    namespace core {
+        // Owns every file we've loaded and lays them out end to end in one 32-bit space, so that a SourceLocation is a single number.
+        // Each file gets its size plus one positions (the extra one is where Eoi sits); position 0 is never handed out.
+        // Safe to use from several threads at once.
+        class SourceManager {
+        private:
+            mutable std::shared_mutex mutex;
+
+            std::vector<std::shared_ptr<SourceBuffer>> buffers; // In the order they were added, which is also the order of their bases.
+            std::vector<std::uint32_t> bases;
+
+            std::uint32_t next = 1;
+        public:
+            SourceManager() = default;
+
+            SourceManager(const SourceManager &) = delete;
+            SourceManager &operator=(const SourceManager &) = delete;
+
+            // Gives the buffer its range of positions; throws std::runtime_error once the 4 GiB of positions are used up.
+            std::shared_ptr<SourceBuffer> add(std::shared_ptr<SourceBuffer> buffer);
+
+            std::shared_ptr<SourceBuffer> getBuffer(SourceLocation location) const; // nullptr for an invalid location.
+
+            std::size_t getFileCount() const;
+
+            // What SourceBuffer::fromFile() and fromSource() register with.
+            static SourceManager &global();
+        };
+    }
+}
+
+#endif /* RTL_CORE_SOURCE_MANAGER_H */
@@ -0,0 +1,60 @@
+#ifndef RTL_CORE_THREAD_POOL_H
+#define RTL_CORE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+
+namespace rtl {
+    namespace core {
+        // Fixed set of worker threads pulling tasks off one queue, first in first out.
+        // submit() hands back a future; an exception thrown by the task comes out of future::get() instead of killing the worker.
+        class ThreadPool {
+        private:
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::deque<std::function<void()>> tasks;
+            bool stopping = false;
+
+            std::vector<std::thread> workers;
+
+            void work();
+        public:
+            ThreadPool(std::size_t threadCount = 0); // 0 means getDefaultThreadCount().
+            ~ThreadPool(); // Runs whatever is still queued, then joins the workers.
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            template<typename F>
+            std::future<std::invoke_result_t<F>> submit(F &&f) {
+                // std::function has to be copyable and packaged_task isn't, hence the shared_ptr.
+                auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+                auto future = task->get_future();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    tasks.emplace_back([task]() { (*task)(); });
+                }
+
+                wake.notify_one();
+                return future;
+            }
+
+            std::size_t getThreadCount() const;
+
+            static std::size_t getDefaultThreadCount(); // One per hardware thread, and at least one.
+        };
+    }
+}
+
+#endif /* RTL_CORE_THREAD_POOL_H */
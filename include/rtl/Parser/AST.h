@@ -10,6 +10,7 @@
 
 #include <cstdint>
 
+#include "rtl/Core/Interner.h"
 #include "rtl/Core/SourceLocation.h"
 
 namespace rtl {
@@ -18,6 +19,8 @@ namespace rtl {
     }
 
     namespace parser {
+        class Module;
+
         // VariableReference, and FunctionReference aren't used by the parser; they are for translating names -> declarations (e.g., name(println) -> funref(fundecl(println)))
         enum class ASTType {
             BuiltinType,
@@ -37,22 +40,54 @@ namespace rtl {
             StructureDescription
         };
 
+        // What a node actually is, in one byte: the statement kinds line up with ASTType and every kind of expression gets its own value, so one switch tells any two nodes apart.
+        enum class ASTKind : std::uint8_t {
+            BuiltinType,
+            VariableDeclaration,
+            VariableDefinition,
+            Return,
+            Block,
+            FunctionHeader,
+            FunctionBody,
+            While,
+            For,
+            Range,
+            Continue,
+            Break,
+            If,
+
+            Ref,
+            Call,
+            Subscript,
+            Literal,
+            Conversion,
+            UnaryOperator,
+            BinaryOperator,
+
+            StructureDescription
+        };
+
+        // Nodes aren't polymorphic; the kind is stored in the node and getType()/getExprType() are worked out from it. See ASTVisitor for dispatching on it.
         struct ASTNode {
             core::SourceLocation begin {}, end {};
+            ASTKind kind;
 
-            virtual ~ASTNode() = default;
+            ASTNode(ASTKind kind);
 
-            virtual ASTType getType() const = 0;
+            ASTType getType() const {
+                if (kind < ASTKind::Ref) return (ASTType)kind;
+                return kind == ASTKind::StructureDescription ? ASTType::StructureDescription : ASTType::Expression;
+            }
         };
 
         struct Type {
-            std::shared_ptr<ASTNode> baseType;
+            ASTNode *baseType = nullptr;
             std::uint32_t pointer;
 
             std::shared_ptr<sema::Type> evaluatedType;
 
             Type() = default;
-            Type(const std::shared_ptr<ASTNode> &baseType, std::uint32_t pointer);
+            Type(ASTNode *baseType, std::uint32_t pointer);
         };
 
         struct ASTBuiltinType : public ASTNode {
@@ -81,8 +116,6 @@ namespace rtl {
             } fpData; // Function-Prototype Type data
 
             ASTBuiltinType(Type builtinType);
-
-            ASTType getType() const;
         };
 
         struct ASTVariableDeclaration : public ASTNode {
@@ -91,39 +124,31 @@ namespace rtl {
                 Constant = 0x2
             };
 
-            std::shared_ptr<ASTNode> name;
+            ASTNode *name = nullptr;
             Type targetTy;
             std::uint32_t flags = 0;
 
-            ASTVariableDeclaration(const std::shared_ptr<ASTNode>& name, const Type &targetTy);
-
-            ASTType getType() const;
+            ASTVariableDeclaration(ASTNode *name, const Type &targetTy);
         };
 
         struct ASTVariableDefinition : public ASTNode {
-            std::shared_ptr<ASTVariableDeclaration> decl;
-            std::shared_ptr<ASTNode> expr;
-
-            ASTVariableDefinition(const std::shared_ptr<ASTVariableDeclaration> &decl, const std::shared_ptr<ASTNode> &expr);
+            ASTVariableDeclaration *decl = nullptr;
+            ASTNode *expr = nullptr;
 
-            ASTType getType() const;
+            ASTVariableDefinition(ASTVariableDeclaration *decl, ASTNode *expr);
         };
 
         struct ASTReturn : public ASTNode {
-            std::shared_ptr<ASTNode> expr;
+            ASTNode *expr = nullptr;
 
-            ASTReturn(const std::shared_ptr<ASTNode> &expr);
-
-            ASTType getType() const;
+            ASTReturn(ASTNode *expr);
         };
 
         struct ASTBlock : public ASTNode {
-            std::shared_ptr<ASTBlock> parent;
-            std::vector<std::shared_ptr<ASTNode>> nodes;
-
-            ASTBlock(const std::vector<std::shared_ptr<ASTNode>>& nodes);
+            ASTBlock *parent = nullptr;
+            std::vector<ASTNode *> nodes;
 
-            ASTType getType() const;
+            ASTBlock(const std::vector<ASTNode *>& nodes);
         };
 
         struct ASTFunctionBody;
@@ -136,74 +161,67 @@ namespace rtl {
                 FastCall = 0x10,
             };
 
-            std::shared_ptr<ASTNode> name;
-            std::shared_ptr<ASTFunctionBody> body;
-            std::vector<std::shared_ptr<ASTVariableDeclaration>> paramDecls;
+            ASTNode *name = nullptr;
+            ASTFunctionBody *body = nullptr;
+            std::vector<ASTVariableDeclaration *> paramDecls;
             Type rt;
             std::shared_ptr<sema::Type> prototype; // Function Prototype
 
             std::uint32_t flags = 0;
 
-            ASTFunctionHeader() = default;
-            ASTFunctionHeader(const std::shared_ptr<ASTNode>& name, const std::vector<std::shared_ptr<ASTVariableDeclaration>>& paramDecls, const Type &rt);
-
-            ASTType getType() const;
+            ASTFunctionHeader();
+            ASTFunctionHeader(ASTNode *name, const std::vector<ASTVariableDeclaration *>& paramDecls, const Type &rt);
         };
 
         struct ASTFunctionBody : public ASTNode {
-            std::shared_ptr<ASTFunctionHeader> header;
-            std::shared_ptr<ASTBlock> block;
+            ASTFunctionHeader *header = nullptr;
+            ASTBlock *block = nullptr; // Null while the body is skimmed; read it through getBlock().
+            Module *skimmed = nullptr; // Set until a skimmed body is parsed; its nodes go in this module. begin and end are the braces.
 
-            ASTFunctionBody() = default;
-            ASTFunctionBody(const std::shared_ptr<ASTBlock>& block);
+            ASTFunctionBody();
+            ASTFunctionBody(ASTBlock *block);
 
-            ASTType getType() const;
+            // Parses a skimmed body the first time it's asked for (see Parser::setSkim()); syntax errors in it are thrown from here.
+            // Not safe to call from two threads on bodies of the same module, since they allocate from its arena.
+            ASTBlock *getBlock();
         };
 
         struct ASTWhile : public ASTNode {
-            std::shared_ptr<ASTNode> condition;
-            std::shared_ptr<ASTNode> statement;
-
-            ASTWhile(const std::shared_ptr<ASTNode> &condition, const std::shared_ptr<ASTNode> &statement);
+            ASTNode *condition = nullptr;
+            ASTNode *statement = nullptr;
 
-            ASTType getType() const;
+            ASTWhile(ASTNode *condition, ASTNode *statement);
         };
 
         struct ASTFor : public ASTNode {
-            std::shared_ptr<ASTNode> expr;
-            std::shared_ptr<ASTNode> statement;
+            ASTNode *expr = nullptr;
+            ASTNode *statement = nullptr;
 
-            ASTFor(const std::shared_ptr<ASTNode> &expr, const std::shared_ptr<ASTNode> &statement);
-
-            ASTType getType() const;
+            ASTFor(ASTNode *expr, ASTNode *statement);
         };
 
         struct ASTRange : public ASTNode {
-            std::shared_ptr<ASTNode> lower;
-            std::shared_ptr<ASTNode> upper;
-
-            ASTRange(const std::shared_ptr<ASTNode> &lower, const std::shared_ptr<ASTNode> &upper);
+            ASTNode *lower = nullptr;
+            ASTNode *upper = nullptr;
 
-            ASTType getType() const;
+            ASTRange(ASTNode *lower, ASTNode *upper);
         };
 
         struct ASTContinue : public ASTNode {
-            ASTType getType() const;
+            ASTContinue();
         };
 
         struct ASTBreak : public ASTNode {
-            ASTType getType() const;
+            ASTBreak();
         };
 
         struct ASTIf : public ASTNode {
-            std::shared_ptr<ASTNode> condition;
-            std::shared_ptr<ASTNode> statement;
-            std::vector<std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>>> elifs;
-            std::shared_ptr<ASTNode> elseStatement;
+            ASTNode *condition = nullptr;
+            ASTNode *statement = nullptr;
+            std::vector<std::pair<ASTNode *, ASTNode *>> elifs;
+            ASTNode *elseStatement = nullptr;
 
-            ASTIf(const std::shared_ptr<ASTNode> &condition, const std::shared_ptr<ASTNode> &statement, const std::vector<std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>>> &elifs, const std::shared_ptr<ASTNode> &elseStatement);
-
-            ASTType getType() const;
+            ASTIf(ASTNode *condition, ASTNode *statement, const std::vector<std::pair<ASTNode *, ASTNode *>> &elifs, ASTNode *elseStatement);
         };
 
         struct ASTExpression : public ASTNode {
@@ -219,36 +237,32 @@ namespace rtl {
 
             std::shared_ptr<sema::Type> evaluatedType;
 
-            virtual Type getExprType() const = 0;
+            ASTExpression(ASTKind kind);
 
-            ASTType getType() const;
+            Type getExprType() const {
+                return (Type)((std::uint8_t)kind - (std::uint8_t)ASTKind::Ref);
+            }
         };
 
         // References another node (e.g., when passing a variable to a function call)
         struct ASTRef : public ASTExpression {
-            std::shared_ptr<ASTNode> node;
-
-            ASTRef(const std::shared_ptr<ASTNode> &node);
+            ASTNode *node = nullptr;
 
-            Type getExprType() const;
+            ASTRef(ASTNode *node);
         };
 
         struct ASTCall : public ASTExpression {
-            std::shared_ptr<ASTNode> called;
-            std::vector<std::shared_ptr<ASTNode>> callArgs;
-
-            ASTCall(const std::shared_ptr<ASTNode>& called, const std::vector<std::shared_ptr<ASTNode>>& callArgs);
+            ASTNode *called = nullptr;
+            std::vector<ASTNode *> callArgs;
 
-            ASTExpression::Type getExprType() const;
+            ASTCall(ASTNode *called, const std::vector<ASTNode *>& callArgs);
         };
 
         struct ASTSubscript : public ASTExpression {
-            std::shared_ptr<ASTNode> indexed;
-            std::shared_ptr<ASTNode> index;
+            ASTNode *indexed = nullptr;
+            ASTNode *index = nullptr;
 
-            ASTSubscript(const std::shared_ptr<ASTNode>& indexed, const std::shared_ptr<ASTNode> index);
-
-            ASTExpression::Type getExprType() const;
+            ASTSubscript(ASTNode *indexed, ASTNode *index);
         };
 
         struct ASTLiteral : public ASTExpression {
@@ -263,7 +277,7 @@ namespace rtl {
 
             Type literalType;
             std::variant<std::uint64_t, double, std::string, char, bool> value;
-            std::size_t hash;
+            core::Symbol name = 0; // Names live in core::Interner::global() rather than in value.
 
             ASTLiteral(std::uint64_t value);
             ASTLiteral(double value);
@@ -275,19 +289,15 @@ namespace rtl {
             // These are just for ease of use
             std::uint64_t getInteger() const;
             double getDecimal() const;
-            const std::string &getString() const;
+            std::string_view getString() const;
             bool getBool() const;
-
-            ASTExpression::Type getExprType() const;
         };
 
         struct ASTConversion : public ASTExpression {
-            std::shared_ptr<ASTNode> from;
+            ASTNode *from = nullptr;
             rtl::parser::Type to;
 
-            ASTConversion(const std::shared_ptr<ASTNode> &from, const rtl::parser::Type &to);
-
-            ASTExpression::Type getExprType() const;
+            ASTConversion(ASTNode *from, const rtl::parser::Type &to);
         };
 
         struct ASTUnaryOperator : public ASTExpression {
@@ -302,11 +312,9 @@ namespace rtl {
             };
 
             Type unopType;
-            std::shared_ptr<ASTNode> node;
-
-            ASTUnaryOperator(Type unopType, const std::shared_ptr<ASTNode>& node);
+            ASTNode *node = nullptr;
 
-            ASTExpression::Type getExprType() const;
+            ASTUnaryOperator(Type unopType, ASTNode *node);
         };
 
         struct ASTBinaryOperator : public ASTExpression {
@@ -344,21 +352,17 @@ namespace rtl {
             };
 
             Type binopType;
-            std::shared_ptr<ASTNode> left, right;
+            ASTNode *left = nullptr, *right = nullptr;
 
-            ASTBinaryOperator(Type binopType, std::shared_ptr<ASTNode> left, std::shared_ptr<ASTNode> right);
-
-            ASTExpression::Type getExprType() const;
+            ASTBinaryOperator(Type binopType, ASTNode *left, ASTNode *right);
         };
 
         struct ASTStructureDescription : public ASTNode {
-            std::shared_ptr<ASTNode> name;
-
-            std::vector<std::shared_ptr<ASTVariableDeclaration>> members;
+            ASTNode *name = nullptr;
 
-            ASTStructureDescription(const std::shared_ptr<ASTNode> &name, const std::vector<std::shared_ptr<ASTVariableDeclaration>> &members);
+            std::vector<ASTVariableDeclaration *> members;
 
-            ASTType getType() const;
+            ASTStructureDescription(ASTNode *name, const std::vector<ASTVariableDeclaration *> &members);
         };
     }
 }
@@ -0,0 +1,75 @@
+#ifndef RTL_PARSER_AST_VISITOR_H
+#define RTL_PARSER_AST_VISITOR_H
+
+#include "rtl/Parser/AST.h"
+
+namespace rtl {
+    namespace parser {
+        // Static visitor: visit() switches once on the node's kind byte and calls Derived's visitX() for it, so there are no virtual calls.
+        // Derived overrides the visitX() it cares about. Expressions it doesn't handle go to visitExpression(), and everything else to visitNode(), which returns Result().
+        // Args are passed along to every visitX() (e.g., the indentation when dumping).
+        template<typename Derived, typename Result = void, typename... Args>
+        class ASTVisitor {
+        private:
+            Derived *self() {
+                return static_cast<Derived *>(this);
+            }
+        public:
+            Result visit(ASTNode *node, Args... args) {
+                switch (node->kind) {
+                    case ASTKind::BuiltinType: return self()->visitBuiltinType(static_cast<ASTBuiltinType *>(node), args...);
+                    case ASTKind::VariableDeclaration: return self()->visitVariableDeclaration(static_cast<ASTVariableDeclaration *>(node), args...);
+                    case ASTKind::VariableDefinition: return self()->visitVariableDefinition(static_cast<ASTVariableDefinition *>(node), args...);
+                    case ASTKind::Return: return self()->visitReturn(static_cast<ASTReturn *>(node), args...);
+                    case ASTKind::Block: return self()->visitBlock(static_cast<ASTBlock *>(node), args...);
+                    case ASTKind::FunctionHeader: return self()->visitFunctionHeader(static_cast<ASTFunctionHeader *>(node), args...);
+                    case ASTKind::FunctionBody: return self()->visitFunctionBody(static_cast<ASTFunctionBody *>(node), args...);
+                    case ASTKind::While: return self()->visitWhile(static_cast<ASTWhile *>(node), args...);
+                    case ASTKind::For: return self()->visitFor(static_cast<ASTFor *>(node), args...);
+                    case ASTKind::Range: return self()->visitRange(static_cast<ASTRange *>(node), args...);
+                    case ASTKind::Continue: return self()->visitContinue(static_cast<ASTContinue *>(node), args...);
+                    case ASTKind::Break: return self()->visitBreak(static_cast<ASTBreak *>(node), args...);
+                    case ASTKind::If: return self()->visitIf(static_cast<ASTIf *>(node), args...);
+                    case ASTKind::Ref: return self()->visitRef(static_cast<ASTRef *>(node), args...);
+                    case ASTKind::Call: return self()->visitCall(static_cast<ASTCall *>(node), args...);
+                    case ASTKind::Subscript: return self()->visitSubscript(static_cast<ASTSubscript *>(node), args...);
+                    case ASTKind::Literal: return self()->visitLiteral(static_cast<ASTLiteral *>(node), args...);
+                    case ASTKind::Conversion: return self()->visitConversion(static_cast<ASTConversion *>(node), args...);
+                    case ASTKind::UnaryOperator: return self()->visitUnaryOperator(static_cast<ASTUnaryOperator *>(node), args...);
+                    case ASTKind::BinaryOperator: return self()->visitBinaryOperator(static_cast<ASTBinaryOperator *>(node), args...);
+                    case ASTKind::StructureDescription: return self()->visitStructureDescription(static_cast<ASTStructureDescription *>(node), args...);
+                }
+
+                return self()->visitNode(node, args...);
+            }
+
+            Result visitNode(ASTNode *, Args...) { return Result(); }
+            Result visitExpression(ASTExpression *node, Args... args) { return self()->visitNode(node, args...); }
+
+            Result visitBuiltinType(ASTBuiltinType *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitVariableDeclaration(ASTVariableDeclaration *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitVariableDefinition(ASTVariableDefinition *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitReturn(ASTReturn *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitBlock(ASTBlock *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitFunctionHeader(ASTFunctionHeader *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitFunctionBody(ASTFunctionBody *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitWhile(ASTWhile *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitFor(ASTFor *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitRange(ASTRange *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitContinue(ASTContinue *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitBreak(ASTBreak *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitIf(ASTIf *node, Args... args) { return self()->visitNode(node, args...); }
+            Result visitStructureDescription(ASTStructureDescription *node, Args... args) { return self()->visitNode(node, args...); }
+
+            Result visitRef(ASTRef *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitCall(ASTCall *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitSubscript(ASTSubscript *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitLiteral(ASTLiteral *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitConversion(ASTConversion *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitUnaryOperator(ASTUnaryOperator *node, Args... args) { return self()->visitExpression(node, args...); }
+            Result visitBinaryOperator(ASTBinaryOperator *node, Args... args) { return self()->visitExpression(node, args...); }
+        };
+    }
+}
+
+#endif /* RTL_PARSER_AST_VISITOR_H */
@@ -0,0 +1,142 @@
+#ifndef RTL_PARSER_FLAT_AST_H
+#define RTL_PARSER_FLAT_AST_H
+
+#include <string_view>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rtl/Parser/AST.h"
+#include "rtl/Parser/Module.h"
+
+namespace rtl {
+    namespace parser {
+        // Index of a node in FlatAST::nodes.
+        using NodeId = std::uint32_t;
+        constexpr NodeId NoNode = UINT32_MAX;
+
+        // A run of IDs in FlatAST::children (or of types in FlatAST::types).
+        struct FlatSpan {
+            std::uint32_t first = 0, count = 0;
+        };
+
+        struct FlatType {
+            NodeId baseType = NoNode;
+            std::uint32_t pointer = 0;
+        };
+
+        // Every node has one of these; 'index' says where its fields are in the array for its kind.
+        struct FlatNode {
+            std::uint8_t type; // ASTType
+            std::uint8_t exprType; // ASTExpression::Type, when type is Expression.
+            std::uint8_t detail; // The builtin type, literal type or operator, for the kinds that have one.
+            std::uint8_t reserved = 0;
+
+            std::uint32_t index;
+            std::uint32_t begin, end; // Byte offsets into the file plus one; 0 if the node has no location.
+        };
+
+        struct FlatBuiltinType {
+            FlatType rt;
+            FlatSpan paramTypes; // Into types.
+        };
+
+        struct FlatVariableDeclaration {
+            NodeId name;
+            FlatType targetTy;
+            std::uint32_t flags;
+        };
+
+        struct FlatBlock {
+            NodeId parent;
+            FlatSpan nodes;
+        };
+
+        struct FlatFunctionHeader {
+            NodeId name, body;
+            FlatSpan paramDecls;
+            FlatType rt;
+            std::uint32_t flags;
+        };
+
+        struct FlatIf {
+            NodeId condition, statement;
+            FlatSpan elifs; // Condition, statement, condition, statement...
+            NodeId elseStatement;
+        };
+
+        struct FlatCall {
+            NodeId called;
+            FlatSpan callArgs;
+        };
+
+        struct FlatLiteral {
+            std::uint64_t bits; // The integer, the double's bits or the bool.
+            FlatSpan text; // Into strings; names, strings and characters.
+        };
+
+        struct FlatConversion {
+            NodeId from;
+            FlatType to;
+        };
+
+        struct FlatStructureDescription {
+            NodeId name;
+            FlatSpan members;
+        };
+
+        // Nodes with one or two children and nothing else: definitions, loops, ranges, subscripts, binary operators...
+        struct FlatPair {
+            NodeId first, second;
+        };
+
+        // A module's tree with no pointers in it: nodes are numbered in the order we reach them from the roots and every kind keeps its fields in its own array.
+        // All of the arrays hold trivially copyable records, so the whole thing goes to and from disk with one memcpy per array.
+        // Semantic results (evaluated types, prototypes) are not kept; sema runs over the pointer tree expand() rebuilds.
+        class FlatAST {
+        private:
+            template<typename Self, typename F>
+            static void forEachArray(Self &self, F &&f); // Every array, in the order serialize() writes them.
+        public:
+            std::uint32_t base = 0; // Where the file starts in core::SourceManager. Not serialized, since that only means something within one run.
+
+            std::vector<FlatNode> nodes;
+            std::vector<NodeId> roots;
+            std::vector<NodeId> children;
+            std::vector<FlatType> types;
+            std::vector<char> strings;
+
+            std::vector<FlatBuiltinType> builtinTypes;
+            std::vector<FlatVariableDeclaration> variableDeclarations;
+            std::vector<FlatPair> variableDefinitions;
+            std::vector<NodeId> returns;
+            std::vector<FlatBlock> blocks;
+            std::vector<FlatFunctionHeader> functionHeaders;
+            std::vector<FlatPair> functionBodies; // Header, block.
+            std::vector<FlatPair> whiles;
+            std::vector<FlatPair> fors;
+            std::vector<FlatPair> ranges;
+            std::vector<FlatIf> ifs;
+            std::vector<NodeId> refs;
+            std::vector<FlatCall> calls;
+            std::vector<FlatPair> subscripts;
+            std::vector<FlatLiteral> literals;
+            std::vector<FlatConversion> conversions;
+            std::vector<NodeId> unaryOperators;
+            std::vector<FlatPair> binaryOperators;
+            std::vector<FlatStructureDescription> structureDescriptions;
+
+            static FlatAST flatten(const Module &module);
+            // Appends the roots to module.nodes. 'base' has to be where the file the tree was flattened from is registered; a location past its end is rejected like a bad ID.
+            void expand(Module &module) const;
+
+            std::vector<char> serialize() const;
+            static FlatAST deserialize(std::string_view bytes); // Throws std::runtime_error if 'bytes' isn't something serialize() wrote.
+
+            std::size_t getSize() const; // Bytes serialize() would write.
+        };
+    }
+}
+
+#endif /* RTL_PARSER_FLAT_AST_H */
@@ -4,17 +4,21 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <memory>
 #include <utility>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "rtl/Core/Arena.h"
 #include "rtl/Core/Error.h"
+#include "rtl/Core/SourceBuffer.h"
 #include "rtl/Core/SourceLocation.h"
 
 namespace rtl {
     namespace parser {
-        enum class TokenType {
+        enum class TokenType : std::uint8_t {
             Invalid,
             Eoi,
 
@@ -155,29 +159,82 @@ namespace rtl {
 
             std::string_view text;
 
-            std::variant < std::string, std::uint64_t, double > litrl; // we have to have std::string here because when we peek multiple tokens ahead the textBuffer gets messed up :()
+            std::variant < std::string_view, std::uint64_t, double > litrl; // Strings point into the source, or into the lexer's arena if they had escapes to decode.
+        };
+
+        // The whole file lexed up front, as parallel arrays rather than an array of Token.
+        // That's 9 bytes a token instead of ~80; Tokens are only rebuilt from it when the parser actually peeks at them.
+        struct TokenStream {
+            std::vector < TokenType > kinds;
+            std::vector < std::uint32_t > begins, ends; // Byte offsets into the source.
+
+            std::vector < std::variant < std::string_view, std::uint64_t, double > > literals; // Payloads of the Integer, Decimal, String and Character tokens, in order.
+        };
+
+        // How hard the parser leaned on the lexer; printed by --parser-stats.
+        struct LookaheadStats {
+            std::size_t peeks = 0; // peek() and peekType() calls.
+            std::size_t eaten = 0; // Tokens consumed.
+            std::size_t furthest = 0; // Largest count passed to peek(), i.e. the parser never looked more than furthest + 1 tokens ahead.
         };
 
         class Lexer {
         private:
-            char textBuffer[8192];
-
+            // Lookahead ring buffer; its size is always a power of two so indices wrap with a mask.
+            // peek() and eat() are O(1) no matter how far ahead the parser looks.
             std::vector < Token > tokens;
+            std::size_t head = 0, buffered = 0;
+
+            void push(Token &&token);
+
+            std::uint32_t cursor = 0; // Offset of the next byte scan() looks at.
+            std::uint32_t base = 0; // The buffer's; see core::SourceManager.
+
+            core::SourceLocation locate(std::uint32_t offset) const;
 
             void next();
             void skip();
 
+            bool scanOperator(Token &token);
+            void scanString(Token &token);
+            void scanNumber(Token &token);
+            void scan(Token &token);
             void once();
+
+            std::shared_ptr<core::SourceBuffer> buffer;
+            std::unique_ptr<core::Arena> strings; // Decoded string literals; lives as long as the current file's tokens.
+
+            std::unique_ptr<TokenStream> stream;
+            std::size_t streamCursor = 0, literalCursor = 0; // Next token (and literal) once() will take from the stream.
+
+            LookaheadStats stats;
         public:
-            core::SourceLocation sourceLocation;
-            std::string source;
+            std::string_view source; // Points into buffer.
 
+            void initFromBuffer(const std::shared_ptr<core::SourceBuffer> &buffer);
             void initFromSource(const std::string & moduleName, const std::string & source);
             void initFromFile(const std::string & filepath);
             // We are using a std::string ^^ here because the filepath has to be null-terminated
 
+            // Lexes bytes 'begin' up to 'end' of the buffer only, as if the file ended at 'end'; see Parser::parseSkimmed().
+            void initFromRange(const std::shared_ptr<core::SourceBuffer> &buffer, std::uint32_t begin, std::uint32_t end);
+
+            const std::shared_ptr<core::SourceBuffer> &getBuffer() const;
+
+            // Lexes the rest of the file into a TokenStream in one go; peek() and eat() are served from it afterwards.
+            // Call it right after init*(); any lexical error in the file is thrown from here.
+            void lexAll();
+            const std::unique_ptr<TokenStream> &getStream() const;
+
+            const LookaheadStats &getStats() const;
+
             const Token & peek(std::size_t count = 0);
+            TokenType peekType(std::size_t count = 0); // Doesn't build a Token when we've lexed everything already.
             void eat(std::size_t count = 1);
+
+            // With a '{' next, eats everything up to and including its matching '}' and returns where that ends.
+            // Nothing in between is turned into tokens: only braces, strings, characters and comments are looked at, so this runs well ahead of scan().
+            core::SourceLocation skipBraces();
         };
     }
 }
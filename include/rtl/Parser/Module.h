@@ -0,0 +1,55 @@
+#ifndef RTL_PARSER_MODULE_H
+#define RTL_PARSER_MODULE_H
+
+#include <cstddef>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rtl/Core/Arena.h"
+#include "rtl/Core/SourceLocation.h"
+#include "rtl/Parser/AST.h"
+
+namespace rtl {
+    namespace parser {
+        // Owns every node parsed out of one file, plus the ones sema adds while resolving it.
+        // Nodes refer to each other with plain pointers and all of them are freed at once when the module is.
+        class Module {
+        private:
+            core::Arena arena;
+            std::size_t nodeCount = 0;
+        public:
+            // An `import "path"` line. Imports aren't nodes; sema never sees them, only ModuleLoader does.
+            struct Import {
+                std::string path; // As written, relative to the importing file.
+                core::SourceLocation begin, end;
+
+                Module *module = nullptr; // What it resolved to; set by ModuleLoader, left null otherwise.
+            };
+
+            std::string path; // The file it was parsed from, when ModuleLoader parsed it.
+
+            std::vector<ASTNode *> nodes; // Top-level declarations in source order.
+            std::vector<Import> imports; // In source order.
+
+            Module() = default;
+
+            Module(const Module &) = delete;
+            Module &operator=(const Module &) = delete;
+
+            template<typename T, typename... Args>
+            T *make(Args &&...args) {
+                ++nodeCount;
+                return arena.make<T>(std::forward<Args>(args)...);
+            }
+
+            // Appends other's top-level nodes to ours and takes ownership of all of its nodes; other is left empty.
+            void merge(Module &&other);
+
+            std::size_t getNodeCount() const;
+        };
+    }
+}
+
+#endif /* RTL_PARSER_MODULE_H */
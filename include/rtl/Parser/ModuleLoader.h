@@ -0,0 +1,63 @@
+#ifndef RTL_PARSER_MODULE_LOADER_H
+#define RTL_PARSER_MODULE_LOADER_H
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cstddef>
+
+#include "rtl/Core/Error.h"
+#include "rtl/Core/ThreadPool.h"
+#include "rtl/Parser/Module.h"
+#include "rtl/Parser/Parser.h"
+
+namespace rtl {
+    namespace parser {
+        // Parses a program's files and everything they import, each one on the pool as soon as somebody asks for it.
+        // An import is scheduled the moment the parser reaches it, so a file's dependencies are being parsed while the rest of it still is.
+        // Files are told apart by canonical path: however many times (and however) a file is imported, it's parsed once and every import of it points at the same Module.
+        class ModuleLoader {
+        private:
+            struct Entry {
+                std::unique_ptr<Module> module;
+                std::unique_ptr<Parser> parser;
+                std::exception_ptr error; // Whatever parsing it threw.
+            };
+
+            core::ThreadPool &pool;
+            bool lexAll, skim;
+
+            std::mutex mutex;
+            std::condition_variable idle;
+            std::size_t pending = 0; // Parses scheduled but not finished.
+
+            std::unordered_map<std::string, std::unique_ptr<Entry>> entries; // By canonical path.
+            std::unordered_map<const Module *, Entry *> byModule;
+            std::vector<Module *> roots; // What load() was called with, in order.
+
+            Module *request(const std::string &path); // The module for 'path', scheduling its parse if nobody has asked for it before.
+            void parse(Entry *entry);
+        public:
+            ModuleLoader(core::ThreadPool &pool, bool lexAll = false, bool skim = false); // See Lexer::lexAll() and Parser::setSkim().
+
+            ModuleLoader(const ModuleLoader &) = delete;
+            ModuleLoader &operator=(const ModuleLoader &) = delete;
+
+            Module *load(const std::string &filepath); // Not parsed yet when this returns; see wait().
+
+            // Blocks until every loaded file and everything it imports is parsed, then checks the import graph for cycles.
+            // Returns the modules with every one after the ones it imports, going through the roots and their imports in source order, so the result doesn't depend on scheduling.
+            // Lex, syntax and cycle errors go to 'errors' in that same order; anything else a parse threw (e.g., an unreadable file) is rethrown.
+            std::vector<Module *> wait(std::vector<core::Error> &errors);
+
+            const Parser &getParser(const Module &module) const;
+        };
+    }
+}
+
+#endif /* RTL_PARSER_MODULE_LOADER_H */
@@ -3,123 +3,87 @@
 
 #include "rtl/Parser/Lexer.h"
 #include "rtl/Parser/AST.h"
+#include "rtl/Parser/Module.h"
 
 #include "rtl/Core/Error.h"
 
+#include <functional>
 #include <utility>
 #include <filesystem>
 
 namespace rtl {
     namespace parser {
-        using MatchType = std::pair<std::size_t, bool>;
-
         class Parser {
         private:
-            std::vector<std::shared_ptr<ASTNode>>& nodes;
+            Module &module; // Every node we build is allocated from it.
             std::unique_ptr<Lexer> lexer;
 
-            std::shared_ptr<ASTNode> nsPrefix {};
-
-            core::Error error; // This is just how we save errors in the matching functions so we can actually report the correct thing. :)
-        public:
-            Parser(std::vector<std::shared_ptr<ASTNode>>& nodes);
-
-            void initFromSource(const std::string &moduleName, const std::string &source);
-            void initFromFile(const std::string &filepath);
-
-            const std::unique_ptr<Lexer>& getLexer() const;
-
-            void parseSyntaxTree();
-            MatchType matchSyntaxTree(std::size_t b = 0);
-
-            std::shared_ptr<ASTNode> parseTopLevel(); // This is used so that we aren't copying code for things like namespaces
-            MatchType matchTopLevel(std::size_t b = 0);
-
-            Type parseType();
-            MatchType matchType(std::size_t b = 0);
+            ASTNode *nsPrefix {};
 
-            std::shared_ptr<ASTVariableDeclaration> parseVariableDeclaration();
-            MatchType matchVariableDeclaration(std::size_t b = 0);
+            std::size_t ruleCalls = 0; // How many parse*() calls it took; see --parser-stats.
 
-            std::shared_ptr<ASTVariableDefinition> parseVariableDefinition();
-            MatchType matchVariableDefinition(std::size_t b = 0);
+            std::function<Module *(const Module::Import &)> importHandler;
 
-            std::shared_ptr<ASTStructureDescription> parseStructureDescription();
-            MatchType matchStructureDescription(std::size_t b = 0);
+            bool skim = false;
 
-            std::shared_ptr<ASTNode> parseStatement();
-            MatchType matchStatement(std::size_t b = 0);
+            // Every rule decides what to do from the next token or two and builds its node as it goes, so each token is looked at once.
+            // Syntax errors are thrown from wherever we first notice them.
+            void expect(TokenType type, const char *message); // Eats the next token if it is 'type', otherwise throws 'message' at it.
+            [[noreturn]] void unexpected();
 
-            std::shared_ptr<ASTBlock> parseBlock();
-            MatchType matchBlock(std::size_t b = 0);
-
-            std::shared_ptr<ASTReturn> parseReturn();
-            MatchType matchReturn(std::size_t b = 0);
+            ASTVariableDeclaration *parseVariableHead(bool &typed); // val/var, the name and the type if there is one.
+            ASTVariableDefinition *parseVariableInitializer(ASTVariableDeclaration *decl);
+        public:
+            Parser(Module &module);
 
-            std::shared_ptr<ASTBreak> parseBreak();
-            MatchType matchBreak(std::size_t b = 0);
+            void initFromSource(const std::string &moduleName, const std::string &source);
+            void initFromFile(const std::string &filepath);
 
-            std::shared_ptr<ASTContinue> parseContinue();
-            MatchType matchContinue(std::size_t b = 0);
+            const std::unique_ptr<Lexer>& getLexer() const;
+            std::size_t getRuleCalls() const;
 
-            std::shared_ptr<ASTFor> parseFor();
-            MatchType matchFor(std::size_t b = 0);
+            // Called as soon as each import is parsed, before the rest of the file; whatever it returns goes in Import::module.
+            void setImportHandler(std::function<Module *(const Module::Import &)> handler);
 
-            std::shared_ptr<ASTRange> parseRange();
-            MatchType matchRange(std::size_t b = 0);
+            // In skim mode function bodies are only brace-matched (see Lexer::skipBraces()) and parsed the first time something calls ASTFunctionBody::getBlock().
+            // Declarations come out the same either way; syntax errors inside a body just turn up later.
+            void setSkim(bool skim);
 
-            std::shared_ptr<ASTWhile> parseWhile();
-            MatchType matchWhile(std::size_t b = 0);
+            static ASTBlock *parseSkimmed(Module &module, ASTFunctionBody *body);
 
-            std::shared_ptr<ASTIf> parseIf();
-            MatchType matchIf(std::size_t b = 0);
+            void parseSyntaxTree();
+            ASTNode *parseTopLevel(); // This is used so that we aren't copying code for things like namespaces
+            void parseImport(); // Adds to module.imports rather than returning a node.
 
-            std::shared_ptr<ASTFunctionHeader> parseFunction();
-            MatchType matchFunction(std::size_t b = 0);
+            Type parseType();
 
-            std::shared_ptr<ASTNode> parseParen();
+            ASTVariableDeclaration *parseVariableDeclaration();
+            ASTVariableDefinition *parseVariableDefinition();
 
-            std::shared_ptr<ASTNode> parseExpr();
+            ASTStructureDescription *parseStructureDescription();
 
-            std::shared_ptr<ASTNode> parseAssignment();
-            std::shared_ptr<ASTNode> parseLogicalOr();
-            std::shared_ptr<ASTNode> parseLogicalAnd();
-            std::shared_ptr<ASTNode> parseDirectComparison();
-            std::shared_ptr<ASTNode> parseComparison();
-            std::shared_ptr<ASTNode> parseBitOr();
-            std::shared_ptr<ASTNode> parseBitXor();
-            std::shared_ptr<ASTNode> parseBitAnd();
-            std::shared_ptr<ASTNode> parseBitShift();
-            std::shared_ptr<ASTNode> parseTerm();
-            std::shared_ptr<ASTNode> parseFactor();
-            std::shared_ptr<ASTNode> parseConversion();
-            std::shared_ptr<ASTNode> parseUnary();
-            std::shared_ptr<ASTNode> parseCallSubscriptOrMember();
-            std::shared_ptr<ASTNode> parseOne();
+            ASTNode *parseStatement();
+            ASTBlock *parseBlock();
+            ASTReturn *parseReturn();
+            ASTBreak *parseBreak();
+            ASTContinue *parseContinue();
+            ASTFor *parseFor();
+            ASTRange *parseRange();
+            ASTWhile *parseWhile();
+            ASTIf *parseIf();
 
-            std::shared_ptr<ASTNode> parseName();
+            ASTFunctionHeader *parseFunction();
 
-            MatchType matchParen(std::size_t b = 0);
+            ASTNode *parseParen();
 
-            MatchType matchExpr(std::size_t b = 0);
+            ASTNode *parseExpr();
 
-            MatchType matchAssignment(std::size_t b = 0);
-            MatchType matchLogicalOr(std::size_t b = 0);
-            MatchType matchLogicalAnd(std::size_t b = 0);
-            MatchType matchDirectComparison(std::size_t b = 0);
-            MatchType matchComparison(std::size_t b = 0);
-            MatchType matchBitOr(std::size_t b = 0);
-            MatchType matchBitXor(std::size_t b = 0);
-            MatchType matchBitAnd(std::size_t b = 0);
-            MatchType matchBitShift(std::size_t b = 0);
-            MatchType matchTerm(std::size_t b = 0);
-            MatchType matchFactor(std::size_t b = 0);
-            MatchType matchConversion(std::size_t b = 0);
-            MatchType matchUnary(std::size_t b = 0);
-            MatchType matchCallSubscriptOrMember(std::size_t b = 0);
-            MatchType matchOne(std::size_t b = 0);
+            ASTNode *parseInfix(std::uint8_t minimum); // Operators binding at least as tightly as 'minimum'; see Precedence in Parser.cpp.
+            ASTNode *parseUnary();
+            ASTNode *parseCallSubscriptOrMember();
+            ASTNode *parseOne();
 
-            MatchType matchName(std::size_t b = 0);
+            ASTNode *parseName();
         };
     }
 }
@@ -2,24 +2,41 @@
 #define RTL_SEMA_DRIVER_H
 
 #include "rtl/Parser/AST.h"
+#include "rtl/Parser/Module.h"
 #include "rtl/Core/Error.h"
+#include "rtl/Core/ThreadPool.h"
 
 #include "Sema.h"
 #include "Type.h"
+#include "Validator.h"
 
 namespace rtl {
     namespace sema {
         // The Driver is the main class in semantic analysis and it first validates the nodes, then types, and type checks them.
         class Driver {
         private:
-            std::vector<std::shared_ptr<parser::ASTNode>> &nodes;
+            parser::Module &module;
             std::vector<core::Error> &errors;
+            core::ThreadPool *pool; // Function bodies are validated on it; without one (or with one thread) sema runs serially.
+            bool lazy = false;
+            bool recordDependencies = false;
 
             std::shared_ptr<BuiltinTypes> builtinTypes;
+            std::shared_ptr<TypeContext> typeContext;
+
+            Validator::Dependencies dependencies;
         public:
-            Driver(std::vector<std::shared_ptr<parser::ASTNode>> &nodes, std::vector<core::Error> &errors);
+            Driver(parser::Module &module, std::vector<core::Error> &errors, core::ThreadPool *pool = nullptr);
+
+            // Only check main and what it uses (see Validator::validateReachable()); errors anywhere else go unreported.
+            void setLazy(bool lazy);
+
+            // Have run() keep what each top-level node refers to for getDependencies(); a lazy run always does.
+            void setRecordDependencies(bool record);
 
             void run();
+
+            const Validator::Dependencies &getDependencies() const; // What each top-level node refers to, as of the last run().
         };
     }
 }
@@ -2,6 +2,7 @@
 #define RTL_SEMA_SEMA_H
 
 #include "Type.h"
+#include "TypeContext.h"
 
 namespace rtl {
     namespace sema {
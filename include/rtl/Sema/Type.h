@@ -45,15 +45,19 @@ namespace rtl {
             Tag getTag() const;
         };
 
+        // Types are made canonical by a TypeContext; don't construct them directly.
+        // Every use of a type shares the one object, so nothing about it can change once it's made: give a node a different type instead.
         class Type {
         private:
-            std::uint32_t pointer;
+            const std::uint32_t pointer;
+            const std::uint32_t id;
         public:
-            std::shared_ptr<TypeDeclaration> decl;
+            const std::shared_ptr<TypeDeclaration> decl;
 
-            Type(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer);
+            Type(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer, std::uint32_t id);
 
             std::uint32_t getPointer() const;
+            std::uint32_t getId() const; // Dense and never 0; equal types have equal IDs.
         };
     }
 }
@@ -0,0 +1,48 @@
+#ifndef RTL_SEMA_TYPECONTEXT_H
+#define RTL_SEMA_TYPECONTEXT_H
+
+#include "Type.h"
+
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtl {
+    namespace sema {
+        // Hands out one canonical Type per distinct type, so two types are the same iff they're the same object (or have the same ID).
+        // Safe to use from several threads at once.
+        class TypeContext {
+        private:
+            struct KeyHash {
+                std::size_t operator()(const std::pair<const TypeDeclaration *, std::uint32_t> &key) const;
+                std::size_t operator()(const std::vector<std::uint32_t> &key) const;
+            };
+
+            mutable std::shared_mutex mutex;
+
+            std::unordered_map<std::pair<const TypeDeclaration *, std::uint32_t>, std::shared_ptr<Type>, KeyHash> types; // (declaration, pointer depth) -> type.
+            std::unordered_map<std::vector<std::uint32_t>, std::shared_ptr<TypeDeclaration>, KeyHash> prototypes; // IDs of the return and parameter types -> prototype.
+            std::vector<std::shared_ptr<Type>> byId;
+        public:
+            TypeContext();
+
+            TypeContext(const TypeContext &) = delete;
+            TypeContext &operator=(const TypeContext &) = delete;
+
+            std::shared_ptr<Type> get(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer);
+
+            std::shared_ptr<TypeDeclaration> getPrototypeDeclaration(const std::shared_ptr<Type> &rt, const std::vector<std::shared_ptr<Type>> &paramTypes);
+            std::shared_ptr<Type> getPrototype(const std::shared_ptr<Type> &rt, const std::vector<std::shared_ptr<Type>> &paramTypes);
+
+            std::shared_ptr<Type> getById(std::uint32_t id) const;
+
+            std::size_t size() const;
+        };
+    }
+}
+
+#endif /* RTL_SEMA_TYPECONTEXT_H */
@@ -5,34 +5,44 @@
 
 #include "rtl/Core/Error.h"
 #include "rtl/Parser/AST.h"
+#include "rtl/Parser/ASTVisitor.h"
 
 namespace rtl {
     namespace sema {
         // This is the part of semantic-analysis which decides what type each node is.
-        class Typer {
+        class Typer : public parser::ASTVisitor<Typer> {
         private:
-            std::vector<std::shared_ptr<parser::ASTNode>> &nodes;
+            std::vector<parser::ASTNode *> &nodes;
             std::vector<core::Error> &errors;
 
             std::shared_ptr<BuiltinTypes> builtinTypes;
+            std::shared_ptr<TypeContext> typeContext; // Every type we hand out comes from here.
             std::vector<std::shared_ptr<TypeDeclaration>> typeDeclarations;
 
-            std::shared_ptr<TypeDeclaration> getTypeDeclaration(const std::shared_ptr<parser::ASTNode> &identifier);
+            std::shared_ptr<TypeDeclaration> getTypeDeclaration(parser::ASTNode *identifier);
             std::shared_ptr<Type> mapType(const parser::Type &type);
 
-            std::shared_ptr<parser::ASTFunctionHeader> currentFunction;
-            std::shared_ptr<parser::ASTBlock> currentBlock;
+            parser::ASTFunctionHeader *currentFunction {};
+            parser::ASTBlock *currentBlock {};
         public:
-            Typer(const std::shared_ptr<BuiltinTypes> &builtinTypes, std::vector<std::shared_ptr<parser::ASTNode>> &nodes, std::vector<core::Error> &errors);
+            Typer(const std::shared_ptr<BuiltinTypes> &builtinTypes, const std::shared_ptr<TypeContext> &typeContext, std::vector<parser::ASTNode *> &nodes, std::vector<core::Error> &errors);
 
-            void typeFunction(const std::shared_ptr<parser::ASTFunctionHeader> &function); // When typing the block if we find a function call that isn't typed we type it.
-            void typeVariableDeclaration(const std::shared_ptr<parser::ASTVariableDeclaration> &decl);
-            void typeVariableDefinition(const std::shared_ptr<parser::ASTVariableDefinition> &defn);
-            void typeExpression(const std::shared_ptr<parser::ASTExpression> &expr);
+            void typeFunction(parser::ASTFunctionHeader *function); // Just the signature; the Validator asks for it through signatureOf(), which remembers it.
+            void typeVariableDeclaration(parser::ASTVariableDeclaration *decl);
+            void typeVariableDefinition(parser::ASTVariableDefinition *defn);
+            void typeExpression(parser::ASTExpression *expr);
 
             void typeType(parser::Type &type);
 
-            void typeNode(const std::shared_ptr<parser::ASTNode> &node);
+            void typeNode(parser::ASTNode *node);
+
+            // ASTVisitor hooks for typeNode().
+            void visitNode(parser::ASTNode *node);
+            void visitFunctionHeader(parser::ASTFunctionHeader *function);
+            void visitVariableDeclaration(parser::ASTVariableDeclaration *decl);
+            void visitVariableDefinition(parser::ASTVariableDefinition *defn);
+            void visitReturn(parser::ASTReturn *returnStatement);
+            void visitExpression(parser::ASTExpression *expr);
         };
     }
 }
@@ -2,62 +2,163 @@
 #define RTL_SEMA_VALIDATOR_H
 
 #include "rtl/Parser/AST.h"
+#include "rtl/Parser/ASTVisitor.h"
+#include "rtl/Parser/Module.h"
 #include "rtl/Core/Error.h"
+#include "rtl/Core/Interner.h"
+
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "Typer.h"
 #include "Sema.h"
 
 namespace rtl {
     namespace sema {
-        class Validator {
+        class Validator : public parser::ASTVisitor<Validator, parser::ASTNode *> {
+        public:
+            // Top-level node -> the top-level functions and variables it refers to, in the order it first does.
+            using Dependencies = std::unordered_map<parser::ASTNode *, std::vector<parser::ASTNode *>>;
         private:
             std::shared_ptr<Typer> typer;
 
             std::shared_ptr<BuiltinTypes> builtinTypes;
-            std::vector<std::shared_ptr<parser::ASTNode>> &nodes;
+            std::shared_ptr<TypeContext> typeContext;
+            parser::Module &module; // The references we resolve names to, and skimmed bodies, are allocated from it.
+            std::vector<parser::ASTNode *> &nodes;
             std::vector<core::Error> &errors;
 
-            std::shared_ptr<parser::ASTFunctionHeader> currentFunction {};
-            std::shared_ptr<parser::ASTBlock> currentBlock {};
-            std::shared_ptr<parser::ASTNode> currentStatement {};
+            parser::ASTFunctionHeader *currentFunction {};
+            parser::ASTBlock *currentBlock {};
+            parser::ASTNode *currentStatement {};
+
+            parser::ASTFor *currentFor {};
+            parser::ASTWhile *currentWhile {};
+
+            parser::ASTNode *currentTopLevel {}; // What depend() records against.
+            std::unordered_set<parser::ASTNode *> used; // What's already in dependencies[currentTopLevel].
+
+            // Name -> the declaration, definition or function it refers to, keyed by nameKey(). A scope keeps the first declaration of a name; later ones are redeclarations.
+            using Scope = std::unordered_map<core::Symbol, parser::ASTNode *>;
+
+            // Innermost last: the current function's parameters, then one scope per block we're in. A block's scope fills up as its statements are validated, so a name is only visible after its declaration.
+            std::vector<Scope> scopes;
+
+            // Top-level functions by name, then by hashTypes() of their parameter types. A bucket keeps declaration order; hash collisions are told apart by comparing the types themselves.
+            using OverloadSet = std::unordered_map<std::size_t, std::vector<parser::ASTFunctionHeader *>>;
+
+            struct Overloads {
+                std::vector<parser::ASTFunctionHeader *> declared; // In declaration order; empty if indexDeclarations() typed them right away.
+                OverloadSet set; // Filled in by overloadsOf(), or by a typed indexDeclarations().
+                bool indexed = false;
+            };
+
+            // What collectDeclarations() gathers from the top level. Nothing writes to it afterwards, so the validators working through the function bodies share one; validateReachable() fills it in as it goes, but runs on one thread.
+            struct Declarations {
+                Scope globals; // Top-level functions and variables.
+                std::unordered_map<core::Symbol, Overloads> functions; // By name; every function is top-level.
+                std::unordered_set<parser::ASTNode *> variables; // The top-level ones.
+
+                // What validating a top-level node out of source order reported: a variable is validated when typeOf() is first asked for it, and validateReachable() does everything that way.
+                // validate() replays it when it gets to the node, so errors still come out in source order.
+                struct Outcome {
+                    std::vector<core::Error> errors;
+                    std::exception_ptr exception;
+
+                    bool done = false; // Unset while the node is being validated; asking for it then means it depends on itself.
+                };
 
-            std::shared_ptr<parser::ASTFor> currentFor {};
-            std::shared_ptr<parser::ASTWhile> currentWhile {};
+                std::unordered_map<parser::ASTNode *, Outcome> outcomes;
+            };
 
-            std::string unqualifyName(const std::shared_ptr<parser::ASTNode> &name);
-            bool compareQualifiedNames(const std::shared_ptr<parser::ASTNode> &left, const std::shared_ptr<parser::ASTNode> &right);
-            std::pair<bool, std::shared_ptr<parser::ASTFunctionHeader>> isRepeatFunctionDeclaration(const std::shared_ptr<parser::ASTFunctionHeader> &decl);
-            std::pair<bool, std::shared_ptr<parser::ASTVariableDeclaration>> isRepeatDeclaration(const std::shared_ptr<parser::ASTVariableDeclaration> &decl);
+            std::shared_ptr<Declarations> declarations;
+            bool recordDependencies = false;
+            Dependencies dependencies; // For the top-level nodes we validated, if recordDependencies is set.
+
+            core::Symbol nameKey(parser::ASTNode *name); // 0 if 'name' isn't a (qualified) name; a::b and a.b get the same key.
+            parser::ASTNode *declaredName(parser::ASTNode *node); // The name a declaration, definition or function declares; nullptr for anything else.
+            void declare(Scope &scope, parser::ASTNode *node);
+            parser::ASTRef *makeRef(parser::ASTNode *node);
+
+            std::string unqualifyName(parser::ASTNode *name);
+            std::pair<bool, parser::ASTFunctionHeader *> isRepeatFunctionDeclaration(parser::ASTFunctionHeader *decl);
+            std::pair<bool, parser::ASTVariableDeclaration *> isRepeatDeclaration(parser::ASTVariableDeclaration *decl);
 
             bool isImplicitlyConvertible(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right);
             bool compareTypes(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right);
+            std::size_t hashTypes(const std::vector<std::shared_ptr<Type>> &types); // Of the types' IDs.
+
+            parser::ASTFunctionHeader *findOverload(core::Symbol name, const std::vector<std::shared_ptr<Type>> &paramTypes); // The first function declared as 'name' taking exactly 'paramTypes'.
+            std::shared_ptr<Type> getArgumentType(parser::ASTNode *arg);
+
+            parser::ASTRef *findQualified(parser::ASTNode *qlf);
+
+            // Queries. Each is worked out once per node and remembered; a top-level variable is only validated when something first needs its type.
+            std::shared_ptr<Type> signatureOf(parser::ASTFunctionHeader *function);
+            std::shared_ptr<Type> typeOf(parser::ASTNode *node); // Of a function, declaration or definition; rethrows whatever stopped a top-level variable from being validated.
+            parser::ASTNode *resolve(core::Symbol name); // The innermost declaration of 'name' in scope, else the first top-level one; nullptr if there's neither.
+            const OverloadSet *overloadsOf(core::Symbol name); // nullptr if no function is called 'name'.
 
-            std::shared_ptr<parser::ASTRef> findQualified(const std::shared_ptr<parser::ASTNode> &qlf);
+            bool isTopLevel(parser::ASTNode *node);
+            void depend(parser::ASTNode *node); // currentTopLevel uses 'node'; ignored unless 'node' is top-level.
+
+            void indexDeclarations(bool typed); // With 'typed', every signature is typed and put in its OverloadSet now; otherwise overloadsOf() does that for the names that get looked up.
+            void validateOutOfOrder(parser::ASTNode *node); // Validates a top-level node into its Outcome, leaving whatever we were in the middle of alone.
+            bool replay(parser::ASTNode *node); // Reports the node's Outcome, if it has one, rethrowing its exception.
         public:
-            Validator(std::shared_ptr<BuiltinTypes> builtinTypes, std::vector<std::shared_ptr<parser::ASTNode>> &nodes, std::vector<core::Error> &errors);
+            Validator(std::shared_ptr<BuiltinTypes> builtinTypes, std::shared_ptr<TypeContext> typeContext, parser::Module &module, std::vector<core::Error> &errors);
+            Validator(const Validator &collected, parser::Module &module, std::vector<core::Error> &errors); // Shares collected's declarations and top-level nodes, but allocates into and reports to its own.
+
+            void validateFunction(parser::ASTFunctionHeader *header);
+            void validateBlock(parser::ASTBlock *block);
+
+            void validateVariableDeclaration(parser::ASTVariableDeclaration *decl);
+            void validateVariableDefinition(parser::ASTVariableDefinition *defn);
+
+            void validateIf(parser::ASTIf *ifStatement);
+
+            void validateFor(parser::ASTFor *forStatement);
+            void validateRange(parser::ASTRange *range);
+            void validateWhile(parser::ASTWhile *whileStatement);
 
-            void validateFunction(const std::shared_ptr<parser::ASTFunctionHeader> &header);
-            void validateBlock(const std::shared_ptr<parser::ASTBlock> &block);
+            void validateContinue(parser::ASTContinue *continueStatement);
+            void validateBreak(parser::ASTBreak *breakStatement);
 
-            void validateVariableDeclaration(const std::shared_ptr<parser::ASTVariableDeclaration> &decl);
-            void validateVariableDefinition(const std::shared_ptr<parser::ASTVariableDefinition> &defn);
+            void validateReturn(parser::ASTReturn *returnStatement);
 
-            void validateIf(const std::shared_ptr<parser::ASTIf> &ifStatement);
+            parser::ASTNode *validateExpression(parser::ASTExpression *expr);
 
-            void validateFor(const std::shared_ptr<parser::ASTFor> &forStatement);
-            void validateRange(const std::shared_ptr<parser::ASTRange> &range);
-            void validateWhile(const std::shared_ptr<parser::ASTWhile> &whileStatement);
+            void validateNode(parser::ASTNode *&node);
 
-            void validateContinue(const std::shared_ptr<parser::ASTContinue> &continueStatement);
-            void validateBreak(const std::shared_ptr<parser::ASTBreak> &breakStatement);
+            // ASTVisitor hooks; each returns what the visited node should be replaced with (a name becomes a reference to its declaration).
+            parser::ASTNode *visitNode(parser::ASTNode *node);
+            parser::ASTNode *visitFunctionHeader(parser::ASTFunctionHeader *header);
+            parser::ASTNode *visitBlock(parser::ASTBlock *block);
+            parser::ASTNode *visitVariableDeclaration(parser::ASTVariableDeclaration *decl);
+            parser::ASTNode *visitVariableDefinition(parser::ASTVariableDefinition *defn);
+            parser::ASTNode *visitIf(parser::ASTIf *ifStatement);
+            parser::ASTNode *visitFor(parser::ASTFor *forStatement);
+            parser::ASTNode *visitRange(parser::ASTRange *range);
+            parser::ASTNode *visitWhile(parser::ASTWhile *whileStatement);
+            parser::ASTNode *visitContinue(parser::ASTContinue *continueStatement);
+            parser::ASTNode *visitBreak(parser::ASTBreak *breakStatement);
+            parser::ASTNode *visitReturn(parser::ASTReturn *returnStatement);
+            parser::ASTNode *visitExpression(parser::ASTExpression *expr);
 
-            void validateReturn(const std::shared_ptr<parser::ASTReturn> &returnStatement);
+            // First phase, serial: index the top level, type every function signature and validate the top-level variables.
+            void collectDeclarations();
+            // Second phase: validate nodes[begin, end). Function bodies only read what the first phase wrote, so disjoint ranges can be validated at once by validators made with the sharing constructor.
+            void validate(std::size_t begin, std::size_t end);
 
-            std::shared_ptr<parser::ASTNode> validateExpression(const std::shared_ptr<parser::ASTExpression> &expr);
+            void validate(); // Both phases over every node.
 
-            void validateNode(std::shared_ptr<parser::ASTNode> &node);
+            // Only validates the functions named 'root' and what they use, transitively, in one thread. A module without any (a library) is validated whole.
+            void validateReachable(core::Symbol root);
 
-            void validate();
+            void setRecordDependencies(bool record); // Off by default; validateReachable() always records them.
+            Dependencies takeDependencies();
         };
     }
 }
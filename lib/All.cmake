@@ -1,5 +1,6 @@
 include_guard()
 
+include(${CMAKE_CURRENT_LIST_DIR}/Bench.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/Compiler.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/Core.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/Parser.cmake)
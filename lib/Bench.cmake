@@ -0,0 +1,17 @@
+include_guard()
+
+include(${CMAKE_CURRENT_LIST_DIR}/Core.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/Parser.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/Sema.cmake)
+
+project(rtlBench)
+
+if (WIN32)
+    add_definitions(-D_CRT_SECURE_NO_WARNINGS)
+endif()
+
+add_definitions(-DFMT_HEADER_ONLY)
+
+add_executable(rtlbench ${CMAKE_CURRENT_LIST_DIR}/Bench/Main.cpp)
+target_include_directories(rtlbench PRIVATE ${CMAKE_CURRENT_LIST_DIR}/../include ${CMAKE_CURRENT_LIST_DIR}/../deps/ya_getopt ${CMAKE_CURRENT_LIST_DIR}/../deps/fmt/include)
+target_link_libraries(rtlbench PRIVATE ya_getopt rtlCore rtlParser rtlSema)
@@ -0,0 +1,435 @@
+#include <string>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <fmt/format.h>
+#include <ya_getopt.h>
+
+#include "rtl/Parser/Lexer.h"
+#include "rtl/Parser/Parser.h"
+#include "rtl/Parser/ModuleLoader.h"
+#include "rtl/Core/Error.h"
+#include "rtl/Core/ThreadPool.h"
+
+#include "rtl/Sema/Driver.h"
+
+// Every workload is generated from a fixed seed, so each run (and each revision) measures the same source; --dump writes it out to try on other builds.
+// The lexer workloads are only ever lexed, so they aren't all valid programs.
+
+void displayUsage(const std::string &programName) {
+    fmt::print(stderr, "usage: {} [options...] workload [size]\n\n", programName);
+    const char *info =
+        "Workloads:\n"
+        "    lookahead   <functions>   peek at every token of a file before eating any of them (default: 1000).\n"
+        "    words       <words>       lex identifiers mixed with keywords (default: 400000).\n"
+        "    numbers     <literals>    lex a lookup table of integer, hex and fractional literals (default: 200000).\n"
+        "    operators   <statements>  lex operator-dense expressions (default: 100000).\n"
+        "    locals      <locals>      check one function that declares this many locals (default: 16000).\n"
+        "    overloads   <groups>      check every function of a file of overloaded calls, 4 functions a group (default: 10000).\n"
+        "    reachable   <groups>      the overloads file, but only checking what main reaches (--lazy-sema; default: 10000).\n"
+        "    project     <files>       parse this many files of 1000 functions each on the pool (default: 64).\n"
+        "\n"
+        "Options:\n"
+        "    -h, --help                display this message and quit.\n"
+        "    -r, --runs  <count>       report the best of this many runs (default: 10).\n"
+        "    -j, --jobs  <count>       parse the project on this many threads (default: one per hardware thread).\n"
+        "        --dump                write the generated source to stdout instead of measuring; for project, its first file.\n"
+    ;
+
+    fmt::print(stderr, "{}", info);
+}
+
+std::string generateFunctions(std::size_t count, const std::string &prefix) {
+    std::string source;
+
+    for (std::size_t i = 0; i < count; i++) {
+        source += fmt::format(
+            "# function {0}\n"
+            "fun {1}_{0}(a: i32, b: i32) -> i32 {{\n"
+            "    /# some block comment #/\n"
+            "    var x: i32 = a * {0} + b\n"
+            "    val y = (x << 2) | 0x{0:x}\n"
+            "    if x > {0} {{\n"
+            "        x = x + 1\n"
+            "    }} elif x < 3 {{\n"
+            "        x -= 2\n"
+            "    }} else {{\n"
+            "        x = x * 2\n"
+            "    }}\n"
+            "    while x > 100 {{\n"
+            "        x = x / 2\n"
+            "    }}\n"
+            "    return x + y\n"
+            "}}\n", i, prefix);
+    }
+
+    return source;
+}
+
+std::string generateWords(std::size_t count) {
+    static const char *keywords[] = { "val", "var", "fun", "if", "elif", "else", "while", "for", "return", "struct", "enum", "union", "switch", "i32", "u8", "u64", "f64", "usize", "true", "false", "none", "size_of" };
+    static const char *identifiers[] = { "x", "idx", "node", "value", "result", "length", "parent", "children", "structure", "whiles", "iffy", "returned", "namespaced", "u128" };
+
+    std::mt19937 random(1);
+    std::string source;
+
+    for (std::size_t i = 0; i < count; i++) {
+        // About 40% keywords; the identifiers are picked to share prefixes and lengths with them.
+        if (random() % 5 < 2) {
+            source += keywords[random() % std::size(keywords)];
+        } else {
+            source += identifiers[random() % std::size(identifiers)];
+        }
+
+        source += i % 12 == 11 ? '\n' : ' ';
+    }
+
+    return source;
+}
+
+std::string generateNumbers(std::size_t count) {
+    std::mt19937_64 random(1);
+    std::string source = "val table: i64 = 0\n";
+
+    for (std::size_t i = 0; i < count; i++) {
+        switch (random() % 3) {
+            case 0: {
+                source += fmt::format("{}", random() >> (random() % 60));
+                break;
+            }
+
+            case 1: {
+                source += fmt::format("0x{:x}", random());
+                break;
+            }
+
+            default: {
+                source += fmt::format("{}.{}", random() % 100000000, random() % 1000000000000);
+                break;
+            }
+        }
+
+        source += i % 8 == 7 ? ",\n" : ", ";
+    }
+
+    return source;
+}
+
+std::string generateOperand(std::mt19937 &random, std::size_t depth) {
+    static const char *atoms[] = { "a", "b", "c", "$k", "p::q", "x.y", "arr[i]", "f(a, b)", "~m", "!n" };
+    static const char *operators[] = { "+", "-", "*", "/", "%", "<<", ">>", "&", "|", "^", "&&", "||", "==", "!=", "<", "<=", ">", ">=" };
+
+    if (depth >= 3 || random() % 3 == 0) {
+        return atoms[random() % std::size(atoms)];
+    }
+
+    std::string left = generateOperand(random, depth + 1);
+    const char *op = operators[random() % std::size(operators)];
+    std::string right = generateOperand(random, depth + 1);
+
+    return fmt::format("({} {} {})", left, op, right);
+}
+
+std::string generateOperators(std::size_t count) {
+    static const char *assignments[] = { "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=" };
+
+    std::mt19937 random(1);
+    std::string source;
+
+    for (std::size_t i = 0; i < count; i++) {
+        const char *op = assignments[random() % std::size(assignments)];
+        source += fmt::format("v{} {} {};\n", i, op, generateOperand(random, 0));
+    }
+
+    return source;
+}
+
+std::string generateLocals(std::size_t count) {
+    std::string source = "fun big(p: i32) -> i32 {\n    var v0: i32 = p\n";
+
+    for (std::size_t i = 1; i < count; i++) {
+        source += fmt::format("    var v{}: i32 = v{} + v{}\n", i, i - 1, i / 2);
+    }
+
+    source += fmt::format("    return v{}\n}}\n", count ? count - 1 : 0);
+    return source;
+}
+
+// Each group is an overloaded pair, a call of both and a call into the next group; main only reaches the first two groups.
+std::string generateOverloads(std::size_t count) {
+    std::string source;
+
+    for (std::size_t i = 0; i < count; i++) {
+        source += fmt::format(
+            "fun fn{0}(a: i32) -> i32 {{\n"
+            "    return a\n"
+            "}}\n"
+            "\n"
+            "fun fn{0}(a: u64) -> u64 {{\n"
+            "    return a\n"
+            "}}\n"
+            "\n"
+            "fun call{0}(a: i32, b: u64) -> u64 {{\n"
+            "    val c: i32 = fn{0}(a)\n"
+            "    return fn{0}(b)\n"
+            "}}\n"
+            "\n"
+            "fun fwd{0}(a: i32) -> i32 {{\n"
+            "    return fn{1}(a)\n"
+            "}}\n"
+            "\n", i, (i + 1) % count);
+    }
+
+    source += "fun main() -> i32 {\n    return fwd0(1)\n}\n";
+    return source;
+}
+
+// Best of 'runs'; 'run' does its own setup and returns how many milliseconds the part being measured took.
+template<typename F>
+double bestOf(std::size_t runs, const F &run) {
+    double best = 0.0;
+
+    for (std::size_t i = 0; i < runs; i++) {
+        double ms = run();
+
+        if (!i || ms < best) {
+            best = ms;
+        }
+    }
+
+    return best;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printTokenRate(const std::string &workload, std::size_t tokens, std::size_t runs, double ms) {
+    fmt::print("{}: {} tokens, best of {} runs: {:.2f} ms, {:.2f}M tokens/s\n", workload, tokens, runs, ms, tokens / ms / 1000.0);
+}
+
+int main(int argc, char **argv) {
+    std::string programName = *argv;
+
+    std::size_t runs = 10;
+    std::size_t jobs = rtl::core::ThreadPool::getDefaultThreadCount();
+    bool dump = false;
+
+    std::array<option, 5> longopts {{
+        { "help", ya_no_argument, nullptr, 'h' },
+        { "runs", ya_required_argument, nullptr, 'r' },
+        { "jobs", ya_required_argument, nullptr, 'j' },
+        { "dump", ya_no_argument, nullptr, 301 },
+        { nullptr, 0, nullptr, 0 }
+    }};
+
+    int optv, longopt;
+    while ((optv = ya_getopt_long_only(argc, argv, "h?r:j:", longopts.data(), &longopt)) != -1) {
+        switch (optv) {
+            case '?':
+            case 'h': {
+                displayUsage(programName);
+                return -1;
+            }
+
+            case 'r':
+            case 'j': {
+                char *end;
+                unsigned long count = std::strtoul(optarg, &end, 10);
+
+                if (*end || !count) {
+                    fmt::print(stderr, "{}: \033[31;1merror: \033[0m'{}' is not a count.\n", programName, optarg);
+                    return -1;
+                }
+
+                (optv == 'r' ? runs : jobs) = count;
+                break;
+            }
+
+            case 301: {
+                dump = true;
+                break;
+            }
+        }
+    }
+
+    argv += optind;
+    argc -= optind;
+
+    if (argc < 1 || argc > 2) {
+        displayUsage(programName);
+        return -1;
+    }
+
+    std::string workload = argv[0];
+    std::size_t size = 0;
+
+    if (argc == 2) {
+        char *end;
+        size = std::strtoul(argv[1], &end, 10);
+
+        if (*end || !size) {
+            fmt::print(stderr, "{}: \033[31;1merror: \033[0m'{}' is not a size.\n", programName, argv[1]);
+            return -1;
+        }
+    }
+
+    auto sizeOr = [&](std::size_t fallback) {
+        return size ? size : fallback;
+    };
+
+    std::string source;
+
+    if (workload == "lookahead") {
+        source = generateFunctions(sizeOr(1000), "fn");
+    } else if (workload == "words") {
+        source = generateWords(sizeOr(400000));
+    } else if (workload == "numbers") {
+        source = generateNumbers(sizeOr(200000));
+    } else if (workload == "operators") {
+        source = generateOperators(sizeOr(100000));
+    } else if (workload == "locals") {
+        source = generateLocals(sizeOr(16000));
+    } else if (workload == "overloads" || workload == "reachable") {
+        source = generateOverloads(sizeOr(10000));
+    } else if (workload == "project") {
+        source = generateFunctions(1000, "fn0");
+    } else {
+        fmt::print(stderr, "{}: \033[31;1merror: \033[0munknown workload '{}'.\n", programName, workload);
+        return -1;
+    }
+
+    if (dump) {
+        fmt::print("{}", source);
+        return 0;
+    }
+
+    try {
+        if (workload == "lookahead") {
+            // The shape of the old speculative parser: look at the whole file through peek(), then eat it a token at a time.
+            std::size_t tokens = 0;
+
+            double ms = bestOf(runs, [&]() {
+                rtl::parser::Lexer lexer;
+                lexer.initFromSource("lookahead.rtl", source);
+
+                auto start = std::chrono::steady_clock::now();
+
+                std::size_t count = 0;
+                while (lexer.peek(count).type != rtl::parser::TokenType::Eoi) {
+                    count++;
+                }
+
+                for (std::size_t i = 0; i < count; i++) {
+                    lexer.peek();
+                    lexer.eat();
+                }
+
+                tokens = count;
+                return millisecondsSince(start);
+            });
+
+            printTokenRate(workload, tokens, runs, ms);
+        } else if (workload == "locals" || workload == "overloads" || workload == "reachable") {
+            std::size_t nodes = 0, errors = 0;
+
+            double ms = bestOf(runs, [&]() {
+                rtl::parser::Module module;
+                rtl::parser::Parser parser(module);
+                parser.initFromSource(workload + ".rtl", source);
+                parser.parseSyntaxTree();
+
+                std::vector<rtl::core::Error> found;
+
+                auto start = std::chrono::steady_clock::now();
+
+                rtl::sema::Driver driver(module, found);
+                driver.setLazy(workload == "reachable");
+                driver.run();
+
+                double elapsed = millisecondsSince(start);
+
+                nodes = module.getNodeCount();
+                errors = found.size();
+                return elapsed;
+            });
+
+            fmt::print("{}: {} nodes, {} errors, best of {} runs: sema {:.2f} ms\n", workload, nodes, errors, runs, ms);
+        } else if (workload == "project") {
+            std::size_t files = sizeOr(64);
+
+            auto directory = std::filesystem::temp_directory_path() / "rtlbench-project";
+            std::filesystem::create_directories(directory);
+
+            std::vector<std::string> paths;
+            for (std::size_t i = 0; i < files; i++) {
+                paths.push_back((directory / fmt::format("f{}.rtl", i)).string());
+
+                std::FILE *file = std::fopen(paths.back().c_str(), "wb");
+                if (!file) {
+                    fmt::print(stderr, "{}: \033[31;1merror: \033[0mcan't write '{}'.\n", programName, paths.back());
+                    return -1;
+                }
+
+                std::string contents = i ? generateFunctions(1000, fmt::format("fn{}", i)) : source;
+                std::fwrite(contents.data(), 1, contents.size(), file);
+                std::fclose(file);
+            }
+
+            std::size_t nodes = 0;
+
+            double ms = bestOf(runs, [&]() {
+                rtl::core::ThreadPool pool(jobs);
+                rtl::parser::ModuleLoader loader(pool);
+
+                auto start = std::chrono::steady_clock::now();
+
+                for (auto &path : paths) {
+                    loader.load(path);
+                }
+
+                std::vector<rtl::core::Error> errors;
+                auto modules = loader.wait(errors);
+
+                double elapsed = millisecondsSince(start);
+
+                nodes = 0;
+                for (auto module : modules) {
+                    nodes += module->getNodeCount();
+                }
+
+                return elapsed;
+            });
+
+            fmt::print("{}: {} files, {} nodes, {} jobs, best of {} runs: {:.1f} ms\n", workload, files, nodes, jobs, runs, ms);
+        } else {
+            std::size_t tokens = 0;
+
+            double ms = bestOf(runs, [&]() {
+                rtl::parser::Lexer lexer;
+                lexer.initFromSource(workload + ".rtl", source);
+
+                auto start = std::chrono::steady_clock::now();
+                lexer.lexAll();
+                double elapsed = millisecondsSince(start);
+
+                tokens = lexer.getStream()->kinds.size();
+                return elapsed;
+            });
+
+            printTokenRate(workload, tokens, runs, ms);
+        }
+    } catch (const rtl::core::Error &e) {
+        fmt::print(stderr, "{}: \033[31;1merror: \033[0m{}\n", programName, e.getMessage());
+        return -1;
+    }
+
+    return 0;
+}
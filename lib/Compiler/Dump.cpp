@@ -1,5 +1,7 @@
 #include "Dump.h"
 
+#include "rtl/Parser/ASTVisitor.h"
+
 #include <fmt/format.h>
 
 // Right now every { and } get their own line because that's the easiest way to dump it LMAO... I'm not lazy... you are.
@@ -56,7 +58,7 @@ namespace rtl {
             }
 
             if (ty.baseType->getType() == ASTType::BuiltinType) {
-                auto builtinType = std::reinterpret_pointer_cast<ASTBuiltinType>(ty.baseType);
+                auto builtinType = static_cast<ASTBuiltinType *>(ty.baseType);
 
                 using Bt = ASTBuiltinType::Type;
 
@@ -150,151 +152,170 @@ namespace rtl {
             return result;
         }
 
-        std::string dumpNode(const std::shared_ptr<ASTNode> &node, std::size_t ind) {
-            std::string result;
-
-            for (std::size_t i = 0; i < ind; i++) result += "    ";
-            if (!node) return result;
+        namespace {
+            class Dumper : public ASTVisitor<Dumper, std::string, std::size_t> {
+            public:
+                std::string visitReturn(ASTReturn *returnStatement, std::size_t /*ind*/) {
+                    return fmt::format("return {}", dumpNode(returnStatement->expr));
+                }
 
-            if (node->getType() == ASTType::Return) {
-                auto returnStatement = std::reinterpret_pointer_cast<ASTReturn>(node);
+                std::string visitRange(ASTRange *range, std::size_t /*ind*/) {
+                    return fmt::format("{}..{}", dumpNode(range->lower), dumpNode(range->upper));
+                }
 
-                result += fmt::format("return {}", dumpNode(returnStatement->expr));
-            } else if (node->getType() == ASTType::Range) {
-                auto range = std::reinterpret_pointer_cast<ASTRange>(node);
+                std::string visitFor(ASTFor *forStatement, std::size_t ind) {
+                    std::string result;
 
-                result += fmt::format("{}..{}", dumpNode(range->lower), dumpNode(range->upper));
-            } else if (node->getType() == ASTType::For) {
-                auto forStatement = std::reinterpret_pointer_cast<ASTFor>(node);
+                    result += fmt::format("for {}\n", dumpNode(forStatement->expr));
+                    if (forStatement->statement->getType() == ASTType::Block) {
+                        result += dumpNode(forStatement->statement, ind);
+                    } else {
+                        result += dumpNode(forStatement->statement, ind + 1);
+                    }
 
-                result += fmt::format("for {}\n", dumpNode(forStatement->expr));
-                if (forStatement->statement->getType() == ASTType::Block) {
-                    result += dumpNode(forStatement->statement, ind);
-                } else {
-                    result += dumpNode(forStatement->statement, ind + 1);
-                }
-            } else if (node->getType() == ASTType::While) {
-                auto whileStatement = std::reinterpret_pointer_cast<ASTWhile>(node);
-
-                result += fmt::format("while {}\n", dumpNode(whileStatement->condition));
-                if (whileStatement->statement->getType() == ASTType::Block) {
-                    result += dumpNode(whileStatement->statement, ind);
-                } else {
-                    result += dumpNode(whileStatement->statement, ind + 1);
-                }
-            } else if (node->getType() == ASTType::If) {
-                auto ifStatement = std::reinterpret_pointer_cast<ASTIf>(node);
-
-                result += fmt::format("if {}\n", dumpNode(ifStatement->condition));
-                if (ifStatement->statement->getType() == ASTType::Block) {
-                    result += dumpNode(ifStatement->statement, ind);
-                } else {
-                    result += dumpNode(ifStatement->statement, ind + 1);
+                    return result;
                 }
 
-                for (auto &elif : ifStatement->elifs) {
-                    result += "\n";
-                    for (std::size_t i = 0; i < ind; i++) result += "    ";
-                    result += fmt::format("elif {}\n", dumpNode(elif.first));
-                    if (elif.second->getType() == ASTType::Block) {
-                        result += dumpNode(elif.second, ind);
+                std::string visitWhile(ASTWhile *whileStatement, std::size_t ind) {
+                    std::string result;
+
+                    result += fmt::format("while {}\n", dumpNode(whileStatement->condition));
+                    if (whileStatement->statement->getType() == ASTType::Block) {
+                        result += dumpNode(whileStatement->statement, ind);
                     } else {
-                        result += dumpNode(elif.second, ind + 1);
+                        result += dumpNode(whileStatement->statement, ind + 1);
                     }
+
+                    return result;
                 }
 
-                if (ifStatement->elseStatement) {
-                    result += " else\n";
-                    if (ifStatement->elseStatement->getType() == ASTType::Block) {
-                        result += dumpNode(ifStatement->elseStatement, ind);
+                std::string visitIf(ASTIf *ifStatement, std::size_t ind) {
+                    std::string result;
+
+                    result += fmt::format("if {}\n", dumpNode(ifStatement->condition));
+                    if (ifStatement->statement->getType() == ASTType::Block) {
+                        result += dumpNode(ifStatement->statement, ind);
                     } else {
-                        result += dumpNode(ifStatement->elseStatement, ind + 1);
+                        result += dumpNode(ifStatement->statement, ind + 1);
+                    }
+
+                    for (auto &elif : ifStatement->elifs) {
+                        result += "\n";
+                        for (std::size_t i = 0; i < ind; i++) result += "    ";
+                        result += fmt::format("elif {}\n", dumpNode(elif.first));
+                        if (elif.second->getType() == ASTType::Block) {
+                            result += dumpNode(elif.second, ind);
+                        } else {
+                            result += dumpNode(elif.second, ind + 1);
+                        }
                     }
+
+                    if (ifStatement->elseStatement) {
+                        result += " else\n";
+                        if (ifStatement->elseStatement->getType() == ASTType::Block) {
+                            result += dumpNode(ifStatement->elseStatement, ind);
+                        } else {
+                            result += dumpNode(ifStatement->elseStatement, ind + 1);
+                        }
+                    }
+
+                    return result;
                 }
-            } else if (node->getType() == ASTType::Block) {
-                auto block = std::reinterpret_pointer_cast<ASTBlock>(node);
 
-                result += "{\n";
-                for (auto &node : block->nodes) {
-                    result += dumpNode(node, ind + 1) + "\n";
+                std::string visitBlock(ASTBlock *block, std::size_t ind) {
+                    std::string result;
+
+                    result += "{\n";
+                    for (auto &node : block->nodes) {
+                        result += dumpNode(node, ind + 1) + "\n";
+                    }
+
+                    for (std::size_t i = 0; i < ind; i++) {
+                        result += "    ";
+                    }
+
+                    result += "}";
+
+                    return result;
                 }
 
-                for (std::size_t i = 0; i < ind; i++) {
-                    result += "    ";
+                std::string visitVariableDeclaration(ASTVariableDeclaration *decl, std::size_t /*ind*/) {
+                    return fmt::format("{} {}: {}", decl->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant ? "val" : "var", dumpNode(decl->name), dumpType(decl->targetTy));
                 }
 
-                result += "}";
-            } else if (node->getType() == ASTType::VariableDeclaration) {
-                auto decl = std::reinterpret_pointer_cast<ASTVariableDeclaration>(node);
+                std::string visitVariableDefinition(ASTVariableDefinition *defn, std::size_t /*ind*/) {
+                    return fmt::format("{} = {}", dumpNode(defn->decl), dumpNode(defn->expr));
+                }
 
-                result += fmt::format("{} {}: {}", decl->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant ? "val" : "var", dumpNode(decl->name), dumpType(decl->targetTy));
-            } else if (node->getType() == ASTType::VariableDefinition) {
-                auto defn = std::reinterpret_pointer_cast<ASTVariableDefinition>(node);
+                std::string visitFunctionHeader(ASTFunctionHeader *header, std::size_t /*ind*/) {
+                    std::string result;
 
-                result += fmt::format("{} = {}", dumpNode(defn->decl), dumpNode(defn->expr));
-            } else if (node->getType() == ASTType::FunctionHeader) {
-                auto header = std::reinterpret_pointer_cast<ASTFunctionHeader>(node);
+                    if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Public) {
+                        result += "pub ";
+                    }
 
-                if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Public) {
-                    result += "pub ";
-                }
+                    result += "fun ";
+                    result += dumpNode(header->name);
+                    result += " (";
 
-                result += "fun ";
-                result += dumpNode(header->name);
-                result += " (";
+                    bool first = true;
+                    for (auto &decl : header->paramDecls) {
+                        if (first) {
+                            first = false;
+                        } else {
+                            result += ", ";
+                        }
 
-                bool first = true;
-                for (auto &decl : header->paramDecls) {
-                    if (first) {
-                        first = false;
-                    } else {
-                        result += ", ";
+                        result += dumpNode(decl);
                     }
 
-                    result += dumpNode(decl);
-                }
+                    result += ") ";
 
-                result += ") ";
+                    if (header->flags) {
+                        result += "[";
 
-                if (header->flags) {
-                    result += "[";
+                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) {
+                            result += "$foreign";
+                        }
 
-                    if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) {
-                        result += "$foreign";
-                    }
+                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern) {
+                            if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
+                            result += "$extern";
+                        }
 
-                    if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern) {
-                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
-                        result += "$extern";
-                    }
+                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::CCall) {
+                            if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
+                            result += "$ccall";
+                        }
 
-                    if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::CCall) {
-                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
-                        result += "$ccall";
+                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::FastCall) {
+                            if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::CCall || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
+                            result += "$fastcall";
+                        }
+
+                        result += "] ";
                     }
 
-                    if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::FastCall) {
-                        if (header->flags & (std::uint32_t)ASTFunctionHeader::Flags::CCall || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern || header->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) result += " ";
-                        result += "$fastcall";
+                    result += fmt::format("-> {}", dumpType(header->rt));
+
+                    if (header->body) {
+                        result += fmt::format("\n{}", dumpNode(header->body));
                     }
 
-                    result += "] ";
+                    return result;
                 }
 
-                result += fmt::format("-> {}", dumpType(header->rt));
+                std::string visitFunctionBody(ASTFunctionBody *body, std::size_t ind) {
+                    // Dumping shouldn't be what parses a skimmed body; only sema gets to decide which bodies are needed.
+                    if (body->skimmed) {
+                        return "{ ... }";
+                    }
 
-                if (header->body) {
-                    result += fmt::format("\n{}", dumpNode(header->body->block));
+                    return dumpNode(body->getBlock(), ind);
                 }
-            } else if (node->getType() == ASTType::FunctionBody) {
-                auto body = std::reinterpret_pointer_cast<ASTFunctionBody>(node);
-
-                result += dumpNode(body->block, ind);
-            } else if (node->getType() == ASTType::Expression) {
-                auto expr = std::reinterpret_pointer_cast<ASTExpression>(node);
 
-                if (expr->getExprType() == ASTExpression::Type::Call) {
-                    auto call = std::reinterpret_pointer_cast<ASTCall>(node);
+                std::string visitCall(ASTCall *call, std::size_t /*ind*/) {
+                    std::string result;
 
                     result += dumpNode(call->called);
                     result += "(";
@@ -309,12 +330,16 @@ namespace rtl {
                         result += dumpNode(node);
                     }
                     result += ")";
-                } else if (expr->getExprType() == ASTExpression::Type::Subscript) {
-                    auto sub = std::reinterpret_pointer_cast<ASTSubscript>(node);
 
-                    result += fmt::format("{}[{}]", dumpNode(sub->indexed), dumpNode(sub->index));
-                } else if (expr->getExprType() == ASTExpression::Type::Literal) {
-                    auto literal = std::reinterpret_pointer_cast<ASTLiteral>(node);
+                    return result;
+                }
+
+                std::string visitSubscript(ASTSubscript *sub, std::size_t /*ind*/) {
+                    return fmt::format("{}[{}]", dumpNode(sub->indexed), dumpNode(sub->index));
+                }
+
+                std::string visitLiteral(ASTLiteral *literal, std::size_t /*ind*/) {
+                    std::string result;
 
                     switch (literal->literalType) {
                         case ASTLiteral::Type::Integer: {
@@ -347,8 +372,12 @@ namespace rtl {
                             break;
                         }
                     }
-                } else if (expr->getExprType() == ASTExpression::Type::Conversion) {
-                    auto conversion = std::reinterpret_pointer_cast<ASTConversion>(node);
+
+                    return result;
+                }
+
+                std::string visitConversion(ASTConversion *conversion, std::size_t /*ind*/) {
+                    std::string result;
 
                     result += "(";
                     result += dumpNode(conversion->from);
@@ -359,8 +388,12 @@ namespace rtl {
                     }
 
                     result += fmt::format("{})", dumpType(conversion->to));
-                } else if (expr->getExprType() == ASTExpression::Type::UnaryOperator) {
-                    auto unop = std::reinterpret_pointer_cast<ASTUnaryOperator>(node);
+
+                    return result;
+                }
+
+                std::string visitUnaryOperator(ASTUnaryOperator *unop, std::size_t /*ind*/) {
+                    std::string result;
 
                     const char *opname;
 
@@ -392,8 +425,12 @@ namespace rtl {
                     }
 
                     result += fmt::format("{}{}", opname, dumpNode(unop->node));
-                } else if (expr->getExprType() == ASTExpression::Type::BinaryOperator) {
-                    auto binop = std::reinterpret_pointer_cast<ASTBinaryOperator>(node);
+
+                    return result;
+                }
+
+                std::string visitBinaryOperator(ASTBinaryOperator *binop, std::size_t /*ind*/) {
+                    std::string result;
 
                     const char *opname;
 
@@ -510,10 +547,19 @@ namespace rtl {
                     else result += opname;
                     result += dumpNode(binop->right);
                     if (binop->binopType != ASTBinaryOperator::Type::NamespaceResolution && binop->binopType != ASTBinaryOperator::Type::MemberResolution) result += ")";
+
+                    return result;
                 }
-            }
+            };
+        }
 
-            return result;
+        std::string dumpNode(ASTNode *node, std::size_t ind) {
+            std::string result;
+
+            for (std::size_t i = 0; i < ind; i++) result += "    ";
+            if (!node) return result;
+
+            return result + Dumper().visit(node, ind);
         }
     }
-}
\ No newline at end of file
+}
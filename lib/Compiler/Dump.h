@@ -5,7 +5,7 @@
 
 namespace rtl {
     namespace compiler {
-        std::string dumpNode(const std::shared_ptr<parser::ASTNode> &node, std::size_t ind = 0);
+        std::string dumpNode(parser::ASTNode *node, std::size_t ind = 0);
     }
 }
 
@@ -1,6 +1,14 @@
 #include <string>
 #include <array>
+#include <memory>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include <fmt/format.h>
 #include <filesystem>
@@ -18,7 +26,12 @@
 
 #include "rtl/Parser/Lexer.h"
 #include "rtl/Parser/Parser.h"
+#include "rtl/Parser/ModuleLoader.h"
+#include "rtl/Parser/FlatAST.h"
 #include "rtl/Core/Error.h"
+#include "rtl/Core/SourceBuffer.h"
+#include "rtl/Core/SourceManager.h"
+#include "rtl/Core/ThreadPool.h"
 
 #include "rtl/Sema/Driver.h"
 
@@ -33,29 +46,18 @@ void displayUsage(const std::string &programName) {
         "    -o, --out           <filename>  set the output file name.\n"
         "    -t, --triple-triple <triple>    set the target triple.\n"
         "    -l, --link          <linkable>  link an external library in the output executable.\n"
+        "    -j, --jobs          <count>     parse files and check function bodies on this many threads (default: one per hardware thread).\n"
+        "        --lex-all                   lex each file up front instead of as the parser asks for tokens.\n"
+        "        --parser-stats              print how much work the parser did per token.\n"
+        "        --emit-ast      <filename>  write the parsed tree to a file in the flat (pointer-free) format.\n"
+        "        --load-ast      <filename>  use a tree --emit-ast wrote for the input file instead of parsing it (its imports aren't loaded).\n"
+        "        --skim                      only brace-match function bodies while parsing; each one is parsed when first needed.\n"
+        "        --lazy-sema                 only check main and what it uses; errors anywhere else go unreported.\n"
     ;
 
     fmt::print(stderr, "{}", info);
 }
 
-std::size_t getNthSubstr(std::size_t n, const std::string_view &str, const std::string_view &substr) {
-    std::size_t c = 0;
-
-    std::size_t pos = 0, last = 0;
-
-    while (c < n && pos != -1) {
-        pos = str.find(substr, last);
-
-        if (pos != -1) {
-            last = pos + 1;
-        }
-
-        ++c;
-    }
-
-    return last;
-}
-
 void colorizeTerminal() {
     #ifdef _WIN32
 
@@ -68,7 +70,7 @@ void colorizeTerminal() {
     #endif
 }
 
-void formatError(const rtl::core::Error &e, const std::string_view &source) {
+void formatError(const rtl::core::Error &e) {
     const char *type = "";
 
     if (e.getType() == rtl::core::Error::Type::Lexical) {
@@ -79,21 +81,18 @@ void formatError(const rtl::core::Error &e, const std::string_view &source) {
         type = "semantic ";
     }
 
-    std::uint32_t line = e.getBegin().line;
-    fmt::print(stderr, "{}:{}:{}-{}: \033[31;1m{}error: \033[0m{}\n\n", e.getBegin().moduleName, line, e.getBegin().lexpos, e.getEnd().lexpos, type, e.getMessage());
-    std::size_t errorLineIndex = getNthSubstr(line - 1,  source, "\n");
-    if (errorLineIndex == -1) {
+    auto buffer = rtl::core::SourceManager::global().getBuffer(e.getBegin());
+    if (!buffer) {
+        fmt::print(stderr, "<unknown>: \033[31;1m{}error: \033[0m{}\n\n", type, e.getMessage());
         fmt::print(stderr, "\t\t\033[35;1m(failed to acquire source)\033[0m");
     } else {
-        std::size_t length = 0;
+        rtl::core::LineColumn begin = buffer->getLineColumn(buffer->getOffset(e.getBegin()));
+        rtl::core::LineColumn end = buffer->getLineColumn(buffer->getOffset(e.getEnd()));
 
-        while (errorLineIndex + length < source.size() && source[errorLineIndex + length] != '\n') {
-            ++length;
-        }
+        fmt::print(stderr, "{}:{}:{}-{}: \033[31;1m{}error: \033[0m{}\n\n", buffer->getName(), begin.line, begin.column, end.column, type, e.getMessage());
+        fmt::print(stderr, "\t\t{}\n\t\t\033[32;1m", buffer->getLine(begin.line));
 
-        fmt::print(stderr, "\t\t{:.{}}\n\t\t\033[32;1m", &source[errorLineIndex], length);
-
-        std::size_t where = e.getBegin().lexpos;
+        std::size_t where = begin.column;
 
         std::size_t i = 1;
 
@@ -103,8 +102,8 @@ void formatError(const rtl::core::Error &e, const std::string_view &source) {
 
         std::fputc('^', stderr);
 
-        if (e.getEnd().line == e.getBegin().line) {
-            while (++i < e.getEnd().lexpos) {
+        if (end.line == begin.line) {
+            while (++i < end.column) {
                 std::fputc('~', stderr);
             }
         }
@@ -128,20 +127,36 @@ int main(int argc, char **argv) {
     bool emitObj = true;
     bool emitAssembly = false;
 
-    std::array<option, 9> longopts {{
+    bool lexAll = false;
+    bool parserStats = false;
+    bool skim = false;
+    bool lazySema = false;
+    std::string astFile;
+    std::string loadAstFile;
+
+    std::size_t jobs = rtl::core::ThreadPool::getDefaultThreadCount();
+
+    std::array<option, 16> longopts {{
         { "help", ya_no_argument, nullptr, 'h' },
         { "compile", ya_no_argument, nullptr, 'c' },
         { "out", ya_required_argument, nullptr, 'o' },
         { "target-triple", ya_required_argument, nullptr, 't' },
         { "link", ya_required_argument, nullptr, 'l' },
+        { "jobs", ya_required_argument, nullptr, 'j' },
         { "emit-llvm", ya_no_argument, nullptr, 301 },
         { "emit-obj", ya_no_argument, nullptr, 302 },
         { "emit-asm", ya_no_argument, nullptr, 303 },
+        { "lex-all", ya_no_argument, nullptr, 304 },
+        { "parser-stats", ya_no_argument, nullptr, 305 },
+        { "emit-ast", ya_required_argument, nullptr, 306 },
+        { "skim", ya_no_argument, nullptr, 307 },
+        { "lazy-sema", ya_no_argument, nullptr, 308 },
+        { "load-ast", ya_required_argument, nullptr, 309 },
         { nullptr, 0, nullptr, 0 }
     }};
 
     int optv, longopt;
-    while ((optv = ya_getopt_long_only(argc, argv, "h?co:t:l:", longopts.data(), &longopt)) != -1) {
+    while ((optv = ya_getopt_long_only(argc, argv, "h?co:t:l:j:", longopts.data(), &longopt)) != -1) {
         switch (optv) {
             case '?':
             case 'h': {
@@ -168,6 +183,49 @@ int main(int argc, char **argv) {
                 links.emplace_back(optarg);
                 break;
             }
+
+            case 'j': {
+                char *end;
+                unsigned long count = std::strtoul(optarg, &end, 10);
+
+                if (*end || !count) {
+                    fmt::print(stderr, "{}: \033[31;1merror: \033[0m'{}' is not a job count.\n", programName, optarg);
+                    return -1;
+                }
+
+                jobs = count;
+                break;
+            }
+
+            case 304: {
+                lexAll = true;
+                break;
+            }
+
+            case 305: {
+                parserStats = true;
+                break;
+            }
+
+            case 306: {
+                astFile = optarg;
+                break;
+            }
+
+            case 307: {
+                skim = true;
+                break;
+            }
+
+            case 308: {
+                lazySema = true;
+                break;
+            }
+
+            case 309: {
+                loadAstFile = optarg;
+                break;
+            }
         }
     }
 
@@ -195,23 +253,113 @@ int main(int argc, char **argv) {
         }
     }
 
-    std::vector<std::shared_ptr<rtl::parser::ASTNode>> nodes;
-    auto parser = std::make_shared<rtl::parser::Parser>(nodes);
-    parser->initFromFile(inputFiles[0]);
+    if (!astFile.empty() && inputFiles.size() > 1) {
+        fmt::print(stderr, "{}: \033[31;1merror: \033[0m--emit-ast takes a single input file.\n", programName);
+        return -1;
+    }
+
+    if (!loadAstFile.empty() && inputFiles.size() > 1) {
+        fmt::print(stderr, "{}: \033[31;1merror: \033[0m--load-ast takes a single input file.\n", programName);
+        return -1;
+    }
+
+    // The tree stands in for parsing the input file. The file is still read, since the tree's locations (and so its diagnostics) point into it.
+    rtl::parser::Module loaded;
+
+    if (!loadAstFile.empty()) {
+        std::string bytes;
+
+        std::FILE *file = std::fopen(loadAstFile.c_str(), "rb");
+        if (!file) {
+            fmt::print(stderr, "{}: \033[31;1merror: \033[0m{}: {}\n", programName, loadAstFile, std::strerror(errno));
+            return -1;
+        }
+
+        char chunk[65536];
+        std::size_t count;
+
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file))) {
+            bytes.append(chunk, count);
+        }
+
+        std::fclose(file);
+
+        try {
+            auto flat = rtl::parser::FlatAST::deserialize(bytes);
+            flat.base = rtl::core::SourceBuffer::fromFile(inputFiles[0])->getBase();
+            flat.expand(loaded);
+        } catch (const std::runtime_error &e) {
+            fmt::print(stderr, "{}: \033[31;1merror: \033[0m{}: {}\n", programName, loadAstFile, e.what());
+            return -1;
+        }
+    }
+
+    // Every file, and everything it imports, is parsed on the pool; see ModuleLoader.
+    // The modules come back in an order that doesn't depend on which parse finished first, and are merged in it.
+    rtl::core::ThreadPool pool(jobs);
+    rtl::parser::ModuleLoader loader(pool, lexAll, skim);
+
+    std::vector<rtl::parser::Module *> roots;
+    if (!loadAstFile.empty()) {
+        roots.push_back(&loaded);
+    } else {
+        for (auto &inputFile : inputFiles) {
+            roots.push_back(loader.load(inputFile));
+        }
+    }
+
+    rtl::parser::Module module;
 
     std::vector<rtl::core::Error> errors;
     try {
-        parser->parseSyntaxTree();
+        std::vector<rtl::parser::Module *> modules = loadAstFile.empty() ? loader.wait(errors) : roots;
+
+        if (errors.size()) {
+            for (auto &e : errors) {
+                formatError(e);
+            }
+
+            fmt::print(stderr, "\n{}: there were errors; we may not continue with compilation.\n", programName);
+            return -1;
+        }
+
+        if (!astFile.empty()) {
+            // Just the input file's tree; the files it imports aren't in it.
+            auto bytes = rtl::parser::FlatAST::flatten(*roots[0]).serialize();
+
+            std::FILE *file = std::fopen(astFile.c_str(), "wb");
+            if (!file || std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+                fmt::print(stderr, "{}: \033[31;1merror: \033[0m{}: {}\n", programName, astFile, std::strerror(errno));
+                if (file) std::fclose(file);
+                return -1;
+            }
+
+            std::fclose(file);
+        }
 
-        for (auto &node : nodes) {
+        for (auto imported : modules) {
+            if (parserStats && loadAstFile.empty()) {
+                const auto &parser = loader.getParser(*imported);
+                const auto &stats = parser.getLexer()->getStats();
+                double tokens = stats.eaten ? (double)stats.eaten : 1.0;
+
+                fmt::print(stderr, "{}: {} tokens, {} rule calls ({:.2f} per token), {} lookahead reads ({:.2f} per token), lookahead depth {}.\n",
+                    parser.getLexer()->getBuffer()->getName(), stats.eaten, parser.getRuleCalls(), parser.getRuleCalls() / tokens, stats.peeks, stats.peeks / tokens, stats.furthest + 1);
+            }
+
+            module.merge(std::move(*imported));
+        }
+
+        for (auto &node : module.nodes) {
             fmt::print("{}\n\n", rtl::compiler::dumpNode(node));
         }
 
-        auto driver = std::make_shared<rtl::sema::Driver>(nodes, errors);
+        auto driver = std::make_shared<rtl::sema::Driver>(module, errors, &pool);
+        driver->setLazy(lazySema);
         driver->run();
 
         for (auto &e : errors) {
-            formatError(e, e.getSource()); // THIS WON'T USE THE RIGHT SOURCE.
+            formatError(e);
         }
 
         if (errors.size()) {
@@ -220,15 +368,13 @@ int main(int argc, char **argv) {
         }
     } catch (const rtl::core::Error &e) {
         for (auto &e : errors) {
-            formatError(e, e.getSource());
+            formatError(e);
         }
 
-        formatError(e, e.getSource());
+        formatError(e);
 
-        if (errors.size()) {
-            fmt::print(stderr, "\n{}: there were errors; we may not continue with compilation.\n", programName);
-            return -1;
-        }
+        fmt::print(stderr, "\n{}: there were errors; we may not continue with compilation.\n", programName);
+        return -1;
     } catch (const std::exception &e) {
         fmt::print(stderr, "{}\n", e.what());
     }
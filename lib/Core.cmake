@@ -2,7 +2,7 @@ include_guard()
 
 project(rtlCore)
 
-set(SOURCES Error.cpp SourceLocation.cpp Timing.cpp)
+set(SOURCES Arena.cpp Error.cpp Interner.cpp Scan.cpp SourceBuffer.cpp SourceLocation.cpp SourceManager.cpp ThreadPool.cpp Timing.cpp)
 list(TRANSFORM SOURCES PREPEND ${CMAKE_CURRENT_LIST_DIR}/Core/)
 
 if (WIN32)
@@ -11,5 +11,8 @@ endif()
 
 add_definitions(-DFMT_HEADER_ONLY)
 
+find_package(Threads REQUIRED)
+
 add_library(rtlCore ${SOURCES})
-target_include_directories(rtlCore PRIVATE ${CMAKE_CURRENT_LIST_DIR}/../include ${CMAKE_CURRENT_LIST_DIR}/../deps/fmt/include)
\ No newline at end of file
+target_include_directories(rtlCore PRIVATE ${CMAKE_CURRENT_LIST_DIR}/../include ${CMAKE_CURRENT_LIST_DIR}/../deps/fmt/include)
+target_link_libraries(rtlCore PUBLIC Threads::Threads)
\ No newline at end of file
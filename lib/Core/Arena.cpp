@@ -0,0 +1,66 @@
+#include "rtl/Core/Arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace rtl {
+    namespace core {
+        Arena::Arena(std::size_t blockSize) {
+            this->blockSize = blockSize;
+        }
+
+        Arena::~Arena() {
+            for (Finalizer *finalizer = finalizers; finalizer; finalizer = finalizer->next) {
+                finalizer->destroy(finalizer->object);
+            }
+        }
+
+        void *Arena::allocate(std::size_t size, std::size_t alignment) {
+            std::uintptr_t aligned = ((std::uintptr_t)cursor + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+
+            if (!cursor || aligned + size > (std::uintptr_t)limit) {
+                // Oversized requests get a block of their own so we don't waste the rest of a normal one.
+                std::size_t length = size + alignment > blockSize ? size + alignment : blockSize;
+
+                blocks.emplace_back(new char[length]);
+                cursor = blocks.back().get();
+                limit = cursor + length;
+
+                aligned = ((std::uintptr_t)cursor + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+            }
+
+            cursor = (char *)(aligned + size);
+            return (void *)aligned;
+        }
+
+        std::string_view Arena::copy(const std::string_view &text) {
+            char *memory = (char *)allocate(text.size(), 1);
+            std::memcpy(memory, text.data(), text.size());
+
+            return std::string_view(memory, text.size());
+        }
+
+        void Arena::absorb(Arena &&other) {
+            blocks.reserve(blocks.size() + other.blocks.size());
+            for (auto &block : other.blocks) {
+                blocks.push_back(std::move(block));
+            }
+
+            other.blocks.clear();
+
+            // Splice other's finalizers in front of ours; their objects don't refer to ours, so the order between the two lists doesn't matter.
+            if (other.finalizers) {
+                Finalizer *last = other.finalizers;
+                while (last->next) {
+                    last = last->next;
+                }
+
+                last->next = finalizers;
+                finalizers = other.finalizers;
+            }
+
+            other.finalizers = nullptr;
+            other.cursor = other.limit = nullptr;
+        }
+    }
+}
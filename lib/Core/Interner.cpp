@@ -0,0 +1,66 @@
+#include "rtl/Core/Interner.h"
+
+#include <functional>
+#include <mutex>
+
+namespace rtl {
+    namespace core {
+        Interner::Interner() {
+            shards[0].strings.emplace_back(); // Symbol 0.
+        }
+
+        Symbol Interner::intern(const std::string_view &text) {
+            // The top bits of the hash, since the shard's map buckets by the low ones.
+            std::size_t which = std::hash<std::string_view>()(text) >> (sizeof(std::size_t) * 8 - shardBits);
+            Shard &shard = shards[which];
+
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+                auto it = shard.symbols.find(text);
+                if (it != shard.symbols.end()) {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            // Somebody may have beaten us to it between the two locks.
+            auto it = shard.symbols.find(text);
+            if (it != shard.symbols.end()) {
+                return it->second;
+            }
+
+            std::string_view stored = shard.arena.copy(text);
+            Symbol symbol = (Symbol)(shard.strings.size() << shardBits | which);
+
+            shard.strings.push_back(stored);
+            shard.symbols.emplace(stored, symbol);
+
+            return symbol;
+        }
+
+        std::string_view Interner::get(Symbol symbol) const {
+            const Shard &shard = shards[symbol & (shardCount - 1)];
+
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            return shard.strings[symbol >> shardBits];
+        }
+
+        std::size_t Interner::size() const {
+            std::size_t size = 0;
+
+            for (auto &shard : shards) {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                size += shard.strings.size();
+            }
+
+            return size - 1;
+        }
+
+        Interner &Interner::global() {
+            static Interner interner;
+            return interner;
+        }
+    }
+}
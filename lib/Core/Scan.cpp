@@ -0,0 +1,190 @@
+#include "rtl/Core/Scan.h"
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define RTL_SCAN_X86
+
+#include <immintrin.h>
+#endif
+
+namespace rtl {
+    namespace core {
+        namespace {
+            bool isBlank(char c) {
+                return c == ' ' || (c >= '\t' && c <= '\r');
+            }
+
+            template<typename Predicate>
+            std::size_t scalarScan(const std::string_view &source, std::size_t from, const Predicate &stop) {
+                for (std::size_t i = from; i < source.size(); i++) {
+                    if (stop(source[i])) {
+                        return i;
+                    }
+                }
+
+                return source.size();
+            }
+
+            void scalarLineStarts(const std::string_view &source, std::size_t from, std::vector<std::uint32_t> &lineStarts) {
+                for (std::size_t i = from; i < source.size(); i++) {
+                    if (source[i] == '\n') {
+                        lineStarts.push_back((std::uint32_t)(i + 1));
+                    }
+                }
+            }
+
+            #ifdef RTL_SCAN_X86
+
+            // `mask` has a bit set for every '\n' in the block starting at `base`.
+            void pushNewlines(std::vector<std::uint32_t> &lineStarts, std::size_t base, std::uint32_t mask) {
+                while (mask) {
+                    lineStarts.push_back((std::uint32_t)(base + (std::size_t)__builtin_ctz(mask) + 1));
+                    mask &= mask - 1;
+                }
+            }
+
+            // Blank bytes are ' ' and the contiguous run '\t'..'\r'.
+            __m128i blankMask128(__m128i bytes) {
+                __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+                __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+                return _mm_or_si128(control, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+            }
+
+            std::size_t skipBlanksSSE2(const std::string_view &source, std::size_t from) {
+                std::size_t i = from;
+
+                for (; i + 16 <= source.size(); i += 16) {
+                    __m128i bytes = _mm_loadu_si128((const __m128i *)(source.data() + i));
+                    std::uint32_t stop = ~(std::uint32_t)_mm_movemask_epi8(blankMask128(bytes)) & 0xFFFF;
+
+                    if (stop) {
+                        return i + (std::size_t)__builtin_ctz(stop);
+                    }
+                }
+
+                return scalarScan(source, i, [](char c) { return !isBlank(c); });
+            }
+
+            std::size_t findEitherSSE2(const std::string_view &source, std::size_t from, char a, char b) {
+                std::size_t i = from;
+
+                for (; i + 16 <= source.size(); i += 16) {
+                    __m128i bytes = _mm_loadu_si128((const __m128i *)(source.data() + i));
+                    std::uint32_t stop = (std::uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(a)), _mm_cmpeq_epi8(bytes, _mm_set1_epi8(b))));
+
+                    if (stop) {
+                        return i + (std::size_t)__builtin_ctz(stop);
+                    }
+                }
+
+                return scalarScan(source, i, [&](char c) { return c == a || c == b; });
+            }
+
+            void collectLineStartsSSE2(const std::string_view &source, std::vector<std::uint32_t> &lineStarts) {
+                std::size_t i = 0;
+
+                for (; i + 16 <= source.size(); i += 16) {
+                    __m128i bytes = _mm_loadu_si128((const __m128i *)(source.data() + i));
+                    pushNewlines(lineStarts, i, (std::uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))));
+                }
+
+                scalarLineStarts(source, i, lineStarts);
+            }
+
+            __attribute__((target("avx2"))) __m256i blankMask256(__m256i bytes) {
+                __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+                __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+                return _mm256_or_si256(control, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+            }
+
+            __attribute__((target("avx2"))) std::size_t skipBlanksAVX2(const std::string_view &source, std::size_t from) {
+                std::size_t i = from;
+
+                for (; i + 32 <= source.size(); i += 32) {
+                    __m256i bytes = _mm256_loadu_si256((const __m256i *)(source.data() + i));
+                    std::uint32_t stop = ~(std::uint32_t)_mm256_movemask_epi8(blankMask256(bytes));
+
+                    if (stop) {
+                        return i + (std::size_t)__builtin_ctz(stop);
+                    }
+                }
+
+                return scalarScan(source, i, [](char c) { return !isBlank(c); });
+            }
+
+            __attribute__((target("avx2"))) std::size_t findEitherAVX2(const std::string_view &source, std::size_t from, char a, char b) {
+                std::size_t i = from;
+
+                for (; i + 32 <= source.size(); i += 32) {
+                    __m256i bytes = _mm256_loadu_si256((const __m256i *)(source.data() + i));
+                    std::uint32_t stop = (std::uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(a)), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(b))));
+
+                    if (stop) {
+                        return i + (std::size_t)__builtin_ctz(stop);
+                    }
+                }
+
+                return scalarScan(source, i, [&](char c) { return c == a || c == b; });
+            }
+
+            __attribute__((target("avx2"))) void collectLineStartsAVX2(const std::string_view &source, std::vector<std::uint32_t> &lineStarts) {
+                std::size_t i = 0;
+
+                for (; i + 32 <= source.size(); i += 32) {
+                    __m256i bytes = _mm256_loadu_si256((const __m256i *)(source.data() + i));
+                    pushNewlines(lineStarts, i, (std::uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'))));
+                }
+
+                scalarLineStarts(source, i, lineStarts);
+            }
+
+            bool hasAVX2() {
+                static const bool supported = __builtin_cpu_supports("avx2");
+                return supported;
+            }
+
+            #endif
+        }
+
+        std::size_t skipBlanks(const std::string_view &source, std::size_t from) {
+            #ifdef RTL_SCAN_X86
+
+            return hasAVX2() ? skipBlanksAVX2(source, from) : skipBlanksSSE2(source, from);
+
+            #else
+
+            return scalarScan(source, from, [](char c) { return !isBlank(c); });
+
+            #endif
+        }
+
+        std::size_t findEither(const std::string_view &source, std::size_t from, char a, char b) {
+            #ifdef RTL_SCAN_X86
+
+            return hasAVX2() ? findEitherAVX2(source, from, a, b) : findEitherSSE2(source, from, a, b);
+
+            #else
+
+            return scalarScan(source, from, [&](char c) { return c == a || c == b; });
+
+            #endif
+        }
+
+        void collectLineStarts(const std::string_view &source, std::vector<std::uint32_t> &lineStarts) {
+            lineStarts.push_back(0);
+
+            #ifdef RTL_SCAN_X86
+
+            if (hasAVX2()) {
+                collectLineStartsAVX2(source, lineStarts);
+            } else {
+                collectLineStartsSSE2(source, lineStarts);
+            }
+
+            #else
+
+            scalarLineStarts(source, 0, lineStarts);
+
+            #endif
+        }
+    }
+}
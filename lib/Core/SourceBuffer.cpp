@@ -0,0 +1,174 @@
+#include "rtl/Core/SourceBuffer.h"
+#include "rtl/Core/SourceManager.h"
+#include "rtl/Core/Scan.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace rtl {
+    namespace core {
+        SourceBuffer::SourceBuffer(const std::string &name) {
+            this->name = name;
+        }
+
+        SourceBuffer::SourceBuffer(const std::string &name, std::string &&contents) {
+            this->name = name;
+            this->contents = std::move(contents);
+
+            data = this->contents.data();
+            size = this->contents.size();
+        }
+
+        SourceBuffer::~SourceBuffer() {
+            #ifndef _WIN32
+
+            if (mapped) {
+                munmap((void *)data, size);
+            }
+
+            #endif
+        }
+
+        std::shared_ptr<SourceBuffer> SourceBuffer::fromFile(const std::string &filepath) {
+            std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(filepath));
+
+            #ifdef _WIN32
+
+            std::FILE *file = std::fopen(filepath.c_str(), "rb");
+            if (!file) {
+                throw std::runtime_error(fmt::format("{}: {}", filepath, std::strerror(errno)));
+            }
+
+            char chunk[65536];
+            std::size_t count;
+
+            while ((count = std::fread(chunk, 1, sizeof(chunk), file))) {
+                buffer->contents.append(chunk, count);
+            }
+
+            std::fclose(file);
+
+            #else
+
+            int fd = open(filepath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error(fmt::format("{}: {}", filepath, std::strerror(errno)));
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                void *mapping = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (mapping != MAP_FAILED) {
+                    // The lexer walks the file front to back exactly once.
+                    madvise(mapping, (std::size_t)st.st_size, MADV_SEQUENTIAL);
+
+                    buffer->data = (const char *)mapping;
+                    buffer->size = (std::size_t)st.st_size;
+                    buffer->mapped = true;
+
+                    close(fd);
+                    return SourceManager::global().add(std::move(buffer));
+                }
+            }
+
+            // Pipes, character devices and anything we failed to map are read in one go.
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+                buffer->contents.reserve((std::size_t)st.st_size);
+            }
+
+            char chunk[65536];
+            ssize_t count;
+
+            while ((count = read(fd, chunk, sizeof(chunk))) != 0) {
+                if (count < 0) {
+                    if (errno == EINTR) continue;
+
+                    int error = errno;
+                    close(fd);
+                    throw std::runtime_error(fmt::format("{}: {}", filepath, std::strerror(error)));
+                }
+
+                buffer->contents.append(chunk, (std::size_t)count);
+            }
+
+            close(fd);
+
+            #endif
+
+            buffer->data = buffer->contents.data();
+            buffer->size = buffer->contents.size();
+
+            return SourceManager::global().add(std::move(buffer));
+        }
+
+        std::shared_ptr<SourceBuffer> SourceBuffer::fromSource(const std::string &name, const std::string_view &source) {
+            return SourceManager::global().add(std::make_shared<SourceBuffer>(name, std::string(source)));
+        }
+
+        const std::string &SourceBuffer::getName() const {
+            return name;
+        }
+
+        std::string_view SourceBuffer::getSource() const {
+            return std::string_view(data, size);
+        }
+
+        bool SourceBuffer::isMapped() const {
+            return mapped;
+        }
+
+        std::uint32_t SourceBuffer::getBase() const {
+            return base;
+        }
+
+        SourceLocation SourceBuffer::getLocation(std::uint32_t offset) const {
+            return SourceLocation(base + offset);
+        }
+
+        std::uint32_t SourceBuffer::getOffset(SourceLocation location) const {
+            return location.position - base;
+        }
+
+        const std::vector<std::uint32_t> &SourceBuffer::getLineStarts() const {
+            std::call_once(lineStartsOnce, [this]() {
+                collectLineStarts(getSource(), lineStarts);
+            });
+
+            return lineStarts;
+        }
+
+        LineColumn SourceBuffer::getLineColumn(std::uint32_t offset) const {
+            const auto &starts = getLineStarts();
+            auto line = std::upper_bound(starts.begin(), starts.end(), offset) - 1;
+
+            return LineColumn { (std::uint32_t)(line - starts.begin()) + 1, offset - *line + 1 };
+        }
+
+        std::string_view SourceBuffer::getLine(std::uint32_t line) const {
+            const auto &starts = getLineStarts();
+
+            if (line == 0 || line > starts.size()) {
+                return std::string_view();
+            }
+
+            std::size_t begin = starts[line - 1];
+            std::size_t end = line < starts.size() ? starts[line] - 1 : size;
+
+            return std::string_view(data + begin, end - begin);
+        }
+    }
+}
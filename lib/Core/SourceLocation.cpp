@@ -1,14 +1,26 @@
 #include "rtl/Core/SourceLocation.h"
+#include "rtl/Core/SourceManager.h"
 
 #include <fmt/format.h>
 
 namespace rtl {
     namespace core {
-        SourceLocation::SourceLocation(const std::string_view &moduleName, std::size_t pointer, std::uint32_t line, std::uint32_t lexpos) : moduleName(moduleName), pointer(pointer), line(line), lexpos(lexpos) {
+        SourceLocation::SourceLocation(std::uint32_t position) : position(position) {
+        }
+
+        bool SourceLocation::isValid() const {
+            return position != 0;
         }
 
         std::string SourceLocation::getFormatted() const {
-            return fmt::format("{}:{}:{}", moduleName, line, lexpos);
+            auto buffer = SourceManager::global().getBuffer(*this);
+
+            if (!buffer) {
+                return fmt::format("<unknown>:+{}", position);
+            }
+
+            LineColumn lineColumn = buffer->getLineColumn(buffer->getOffset(*this));
+            return fmt::format("{}:{}:{}", buffer->getName(), lineColumn.line, lineColumn.column);
         }
     }
-}
\ No newline at end of file
+}
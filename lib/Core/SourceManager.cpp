@@ -0,0 +1,52 @@
+#include "rtl/Core/SourceManager.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace rtl {
+    namespace core {
+        std::shared_ptr<SourceBuffer> SourceManager::add(std::shared_ptr<SourceBuffer> buffer) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+
+            if (buffer->size >= (std::uint64_t)UINT32_MAX - next) {
+                throw std::runtime_error(fmt::format("{}: too much source; locations only have 32 bits.", buffer->name));
+            }
+
+            buffer->base = next;
+            next += (std::uint32_t)buffer->size + 1;
+
+            buffers.push_back(buffer);
+            bases.push_back(buffer->base);
+
+            return buffer;
+        }
+
+        std::shared_ptr<SourceBuffer> SourceManager::getBuffer(SourceLocation location) const {
+            if (!location.isValid()) {
+                return nullptr;
+            }
+
+            std::shared_lock<std::shared_mutex> lock(mutex);
+
+            auto it = std::upper_bound(bases.begin(), bases.end(), location.position);
+            if (it == bases.begin() || location.position >= next) {
+                return nullptr;
+            }
+
+            return buffers[it - bases.begin() - 1];
+        }
+
+        std::size_t SourceManager::getFileCount() const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return buffers.size();
+        }
+
+        SourceManager &SourceManager::global() {
+            static SourceManager manager;
+            return manager;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "rtl/Core/ThreadPool.h"
+
+namespace rtl {
+    namespace core {
+        ThreadPool::ThreadPool(std::size_t threadCount) {
+            if (!threadCount) {
+                threadCount = getDefaultThreadCount();
+            }
+
+            workers.reserve(threadCount);
+            for (std::size_t i = 0; i < threadCount; i++) {
+                workers.emplace_back(&ThreadPool::work, this);
+            }
+        }
+
+        ThreadPool::~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+
+            wake.notify_all();
+
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        }
+
+        void ThreadPool::work() {
+            while (true) {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                    if (tasks.empty()) {
+                        return; // Only happens once we're stopping.
+                    }
+
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        std::size_t ThreadPool::getThreadCount() const {
+            return workers.size();
+        }
+
+        std::size_t ThreadPool::getDefaultThreadCount() {
+            unsigned count = std::thread::hardware_concurrency();
+            return count ? count : 1;
+        }
+    }
+}
@@ -4,7 +4,7 @@ include(${CMAKE_CURRENT_LIST_DIR}/Core.cmake)
 
 project(rtlParser)
 
-set(SOURCES AST.cpp Lexer.cpp Parser.cpp)
+set(SOURCES AST.cpp FlatAST.cpp Lexer.cpp Module.cpp ModuleLoader.cpp Parser.cpp)
 
 list(TRANSFORM SOURCES PREPEND ${CMAKE_CURRENT_LIST_DIR}/Parser/)
 
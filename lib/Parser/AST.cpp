@@ -1,170 +1,135 @@
-#include "rtl/parser/AST.h"
+#include "rtl/Parser/AST.h"
+#include "rtl/Parser/Parser.h"
 
 namespace rtl {
     namespace parser {
-        Type::Type(const std::shared_ptr<ASTNode> &baseType, std::uint32_t pointer) {
+        static_assert((std::uint8_t)ASTKind::If == (std::uint8_t)ASTType::If, "statement kinds have to line up with ASTType.");
+        static_assert((std::uint8_t)ASTKind::BinaryOperator - (std::uint8_t)ASTKind::Ref == (std::uint8_t)ASTExpression::Type::BinaryOperator, "expression kinds have to line up with ASTExpression::Type.");
+
+        ASTNode::ASTNode(ASTKind kind) {
+            this->kind = kind;
+        }
+
+        Type::Type(ASTNode *baseType, std::uint32_t pointer) {
             this->baseType = baseType;
             this->pointer = pointer;
         }
 
-        ASTBuiltinType::ASTBuiltinType(Type builtinType) {
+        ASTBuiltinType::ASTBuiltinType(Type builtinType) : ASTNode(ASTKind::BuiltinType) {
             this->builtinType = builtinType;
         }
 
-        ASTType ASTBuiltinType::getType() const {
-            return ASTType::BuiltinType;
-        }
-
-        ASTVariableDeclaration::ASTVariableDeclaration(const std::shared_ptr<ASTNode>& name, const Type &targetTy) {
+        ASTVariableDeclaration::ASTVariableDeclaration(ASTNode *name, const Type &targetTy) : ASTNode(ASTKind::VariableDeclaration) {
             this->name = name;
             this->targetTy = targetTy;
         }
 
-        ASTType ASTVariableDeclaration::getType() const {
-            return ASTType::VariableDeclaration;
-        }
-
-        ASTVariableDefinition::ASTVariableDefinition(const std::shared_ptr<ASTVariableDeclaration> &decl, const std::shared_ptr<ASTNode> &expr) {
+        ASTVariableDefinition::ASTVariableDefinition(ASTVariableDeclaration *decl, ASTNode *expr) : ASTNode(ASTKind::VariableDefinition) {
             this->decl = decl;
             this->expr = expr;
         }
 
-        ASTType ASTVariableDefinition::getType() const {
-            return ASTType::VariableDefinition;
-        }
-
-        ASTReturn::ASTReturn(const std::shared_ptr<ASTNode> &expr) {
+        ASTReturn::ASTReturn(ASTNode *expr) : ASTNode(ASTKind::Return) {
             this->expr = expr;
         }
 
-        ASTType ASTReturn::getType() const {
-            return ASTType::Return;
-        }
-
-        ASTBlock::ASTBlock(const std::vector<std::shared_ptr<ASTNode>>& nodes) {
+        ASTBlock::ASTBlock(const std::vector<ASTNode *>& nodes) : ASTNode(ASTKind::Block) {
             this->nodes = nodes;
         }
 
-        ASTType ASTBlock::getType() const {
-            return ASTType::Block;
+        ASTFunctionHeader::ASTFunctionHeader() : ASTNode(ASTKind::FunctionHeader) {
         }
 
-        ASTFunctionHeader::ASTFunctionHeader(const std::shared_ptr<ASTNode>& name, const std::vector<std::shared_ptr<ASTVariableDeclaration>>& paramDecls, const Type &rt) {
+        ASTFunctionHeader::ASTFunctionHeader(ASTNode *name, const std::vector<ASTVariableDeclaration *>& paramDecls, const Type &rt) : ASTNode(ASTKind::FunctionHeader) {
             this->name = name;
             this->paramDecls = paramDecls;
             this->rt = rt;
         }
 
-        ASTType ASTFunctionHeader::getType() const {
-            return ASTType::FunctionHeader;
+        ASTFunctionBody::ASTFunctionBody() : ASTNode(ASTKind::FunctionBody) {
         }
 
-        ASTFunctionBody::ASTFunctionBody(const std::shared_ptr<ASTBlock>& block) {
+        ASTFunctionBody::ASTFunctionBody(ASTBlock *block) : ASTNode(ASTKind::FunctionBody) {
             this->block = block;
         }
 
-        ASTType ASTFunctionBody::getType() const {
-            return ASTType::FunctionBody;
+        ASTBlock *ASTFunctionBody::getBlock() {
+            if (skimmed) {
+                block = Parser::parseSkimmed(*skimmed, this);
+                skimmed = nullptr;
+            }
+
+            return block;
         }
 
-        ASTWhile::ASTWhile(const std::shared_ptr<ASTNode> &condition, const std::shared_ptr<ASTNode> &statement) {
+        ASTWhile::ASTWhile(ASTNode *condition, ASTNode *statement) : ASTNode(ASTKind::While) {
             this->condition = condition;
             this->statement = statement;
         }
 
-        ASTType ASTWhile::getType() const {
-            return ASTType::While;
-        }
-
-        ASTFor::ASTFor(const std::shared_ptr<ASTNode> &expr, const std::shared_ptr<ASTNode> &statement) {
+        ASTFor::ASTFor(ASTNode *expr, ASTNode *statement) : ASTNode(ASTKind::For) {
             this->expr = expr;
             this->statement = statement;
         }
 
-        ASTType ASTFor::getType() const {
-            return ASTType::For;
-        }
-
-        ASTRange::ASTRange(const std::shared_ptr<ASTNode> &lower, const std::shared_ptr<ASTNode> &upper) {
+        ASTRange::ASTRange(ASTNode *lower, ASTNode *upper) : ASTNode(ASTKind::Range) {
             this->lower = lower;
             this->upper = upper;
         }
 
-        ASTType ASTRange::getType() const {
-            return ASTType::Range;
-        }
-
-        ASTType ASTContinue::getType() const {
-            return ASTType::Continue;
+        ASTContinue::ASTContinue() : ASTNode(ASTKind::Continue) {
         }
 
-        ASTType ASTBreak::getType() const {
-            return ASTType::Break;
+        ASTBreak::ASTBreak() : ASTNode(ASTKind::Break) {
         }
 
-        ASTIf::ASTIf(const std::shared_ptr<ASTNode> &condition, const std::shared_ptr<ASTNode> &statement, const std::vector<std::pair<std::shared_ptr<ASTNode>, std::shared_ptr<ASTNode>>> &elifs, const std::shared_ptr<ASTNode> &elseStatement) {
+        ASTIf::ASTIf(ASTNode *condition, ASTNode *statement, const std::vector<std::pair<ASTNode *, ASTNode *>> &elifs, ASTNode *elseStatement) : ASTNode(ASTKind::If) {
             this->condition = condition;
             this->statement = statement;
             this->elifs = elifs;
             this->elseStatement = elseStatement;
         }
 
-        ASTType ASTIf::getType() const {
-            return ASTType::If;
-        }
-
-        ASTType ASTExpression::getType() const {
-           return ASTType::Expression;
+        ASTExpression::ASTExpression(ASTKind kind) : ASTNode(kind) {
         }
 
-        ASTRef::ASTRef(const std::shared_ptr<ASTNode> &node) {
+        ASTRef::ASTRef(ASTNode *node) : ASTExpression(ASTKind::Ref) {
             this->node = node;
         }
 
-        ASTExpression::Type ASTRef::getExprType() const {
-            return ASTExpression::Type::Ref;
-        }
-
-        ASTCall::ASTCall(const std::shared_ptr<ASTNode>& called, const std::vector<std::shared_ptr<ASTNode>>& callArgs) {
+        ASTCall::ASTCall(ASTNode *called, const std::vector<ASTNode *>& callArgs) : ASTExpression(ASTKind::Call) {
             this->called = called;
             this->callArgs = callArgs;
         }
 
-        ASTExpression::Type ASTCall::getExprType() const {
-            return ASTExpression::Type::Call;
-        }
-
-        ASTSubscript::ASTSubscript(const std::shared_ptr<ASTNode>& indexed, const std::shared_ptr<ASTNode> index) {
+        ASTSubscript::ASTSubscript(ASTNode *indexed, ASTNode *index) : ASTExpression(ASTKind::Subscript) {
             this->indexed = indexed;
             this->index = index;
         }
 
-        ASTExpression::Type ASTSubscript::getExprType() const {
-            return ASTExpression::Type::Subscript;
-        }
-
-        ASTLiteral::ASTLiteral(std::uint64_t value) {
+        ASTLiteral::ASTLiteral(std::uint64_t value) : ASTExpression(ASTKind::Literal) {
             literalType = Type::Integer;
             this->value = value;
-            hash = std::hash<decltype(value)>()(value);
         }
 
-        ASTLiteral::ASTLiteral(double value) {
+        ASTLiteral::ASTLiteral(double value) : ASTExpression(ASTKind::Literal) {
             literalType = Type::Decimal;
             this->value = value;
-            hash = std::hash<decltype(value)>()(value);
         }
 
-        ASTLiteral::ASTLiteral(const std::string_view &value, Type ty) {
+        ASTLiteral::ASTLiteral(const std::string_view &value, Type ty) : ASTExpression(ASTKind::Literal) {
             literalType = ty;
-            this->value = std::string(value.data(), value.size());
-            hash = std::hash<std::string_view>()(value);
+
+            if (ty == Type::Name) {
+                name = core::Interner::global().intern(value);
+            } else {
+                this->value = std::string(value.data(), value.size());
+            }
         }
 
-        ASTLiteral::ASTLiteral(bool value) {
+        ASTLiteral::ASTLiteral(bool value) : ASTExpression(ASTKind::Literal) {
             literalType = Type::Bool;
             this->value = value;
-            hash = std::hash<decltype(value)>()(value);
         }
 
         ASTLiteral::~ASTLiteral() {
@@ -178,7 +143,11 @@ namespace rtl {
             return std::get<double>(value);
         }
 
-        const std::string &ASTLiteral::getString() const {
+        std::string_view ASTLiteral::getString() const {
+            if (literalType == Type::Name) {
+                return core::Interner::global().get(name);
+            }
+
             return std::get<std::string>(value);
         }
 
@@ -186,45 +155,25 @@ namespace rtl {
             return std::get<bool>(value);
         }
 
-        ASTExpression::Type ASTLiteral::getExprType() const {
-            return ASTExpression::Type::Literal;
-        }
-
-        ASTConversion::ASTConversion(const std::shared_ptr<ASTNode> &from, const rtl::parser::Type &to) {
+        ASTConversion::ASTConversion(ASTNode *from, const rtl::parser::Type &to) : ASTExpression(ASTKind::Conversion) {
             this->from = from;
             this->to = to;
         }
 
-        ASTExpression::Type ASTConversion::getExprType() const {
-            return ASTExpression::Type::Conversion;
-        }
-
-        ASTUnaryOperator::ASTUnaryOperator(ASTUnaryOperator::Type unopType, const std::shared_ptr<ASTNode>& node) {
+        ASTUnaryOperator::ASTUnaryOperator(ASTUnaryOperator::Type unopType, ASTNode *node) : ASTExpression(ASTKind::UnaryOperator) {
             this->unopType = unopType;
             this->node = node;
         }
 
-        ASTExpression::Type ASTUnaryOperator::getExprType() const {
-            return ASTExpression::Type::UnaryOperator;
-        }
-
-        ASTBinaryOperator::ASTBinaryOperator(Type binopType, std::shared_ptr<ASTNode> left, std::shared_ptr<ASTNode> right) {
+        ASTBinaryOperator::ASTBinaryOperator(Type binopType, ASTNode *left, ASTNode *right) : ASTExpression(ASTKind::BinaryOperator) {
             this->binopType = binopType;
             this->left = left;
             this->right = right;
         }
 
-        ASTExpression::Type ASTBinaryOperator::getExprType() const {
-            return ASTExpression::Type::BinaryOperator;
-        }
-
-        ASTStructureDescription::ASTStructureDescription(const std::shared_ptr<ASTNode> &name, const std::vector<std::shared_ptr<ASTVariableDeclaration>> &members) {
+        ASTStructureDescription::ASTStructureDescription(ASTNode *name, const std::vector<ASTVariableDeclaration *> &members) : ASTNode(ASTKind::StructureDescription) {
             this->name = name;
             this->members = members;
         }
-
-        ASTType ASTStructureDescription::getType() const {
-            return ASTType::StructureDescription;
-        }
     }
 }
@@ -0,0 +1,806 @@
+#include "rtl/Parser/FlatAST.h"
+
+#include "rtl/Core/SourceManager.h"
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace rtl {
+    namespace parser {
+        namespace {
+            constexpr char magic[4] = { 'R', 'T', 'L', 'A' };
+            constexpr std::uint32_t version = 2;
+
+            class Flattener {
+            private:
+                FlatAST &flat;
+                std::unordered_map<const ASTNode *, NodeId> ids; // Refs, bodies and parents point back at nodes we've already numbered.
+
+                FlatSpan span(const std::vector<NodeId> &ids) {
+                    FlatSpan result { (std::uint32_t)flat.children.size(), (std::uint32_t)ids.size() };
+                    flat.children.insert(flat.children.end(), ids.begin(), ids.end());
+                    return result;
+                }
+
+                FlatSpan text(std::string_view text) {
+                    FlatSpan result { (std::uint32_t)flat.strings.size(), (std::uint32_t)text.size() };
+                    flat.strings.insert(flat.strings.end(), text.begin(), text.end());
+                    return result;
+                }
+
+                FlatType type(const Type &type) {
+                    return FlatType { visit(type.baseType), type.pointer };
+                }
+
+                std::uint32_t offset(core::SourceLocation location) {
+                    return location.isValid() ? location.position - flat.base + 1 : 0;
+                }
+
+                template<typename T>
+                std::uint32_t add(std::vector<T> &array, const T &record) {
+                    array.push_back(record);
+                    return (std::uint32_t)array.size() - 1;
+                }
+            public:
+                Flattener(FlatAST &flat, std::size_t nodeCount) : flat(flat) {
+                    ids.reserve(nodeCount);
+                }
+
+                NodeId visit(const ASTNode *node) {
+                    if (!node) {
+                        return NoNode;
+                    }
+
+                    auto it = ids.find(node);
+                    if (it != ids.end()) {
+                        return it->second;
+                    }
+
+                    // Numbered before its children so that anything pointing back up finds it.
+                    NodeId id = (NodeId)flat.nodes.size();
+                    ids.emplace(node, id);
+                    flat.nodes.push_back(FlatNode { (std::uint8_t)node->getType(), 0, 0, 0, 0, offset(node->begin), offset(node->end) });
+
+                    std::uint8_t exprType = 0, detail = 0;
+                    std::uint32_t index = 0;
+
+                    switch (node->getType()) {
+                        case ASTType::BuiltinType: {
+                            auto builtinType = static_cast<const ASTBuiltinType *>(node);
+                            detail = (std::uint8_t)builtinType->builtinType;
+
+                            FlatBuiltinType record;
+
+                            if (builtinType->builtinType == ASTBuiltinType::Type::FunctionPrototype) {
+                                record.rt = type(builtinType->fpData.rt);
+
+                                std::vector<FlatType> paramTypes;
+                                for (auto &paramType : builtinType->fpData.paramTypes) {
+                                    paramTypes.push_back(type(paramType));
+                                }
+
+                                record.paramTypes = FlatSpan { (std::uint32_t)flat.types.size(), (std::uint32_t)paramTypes.size() };
+                                flat.types.insert(flat.types.end(), paramTypes.begin(), paramTypes.end());
+                            }
+
+                            index = add(flat.builtinTypes, record);
+                            break;
+                        }
+
+                        case ASTType::VariableDeclaration: {
+                            auto decl = static_cast<const ASTVariableDeclaration *>(node);
+                            index = add(flat.variableDeclarations, FlatVariableDeclaration { visit(decl->name), type(decl->targetTy), decl->flags });
+                            break;
+                        }
+
+                        case ASTType::VariableDefinition: {
+                            auto defn = static_cast<const ASTVariableDefinition *>(node);
+                            index = add(flat.variableDefinitions, FlatPair { visit(defn->decl), visit(defn->expr) });
+                            break;
+                        }
+
+                        case ASTType::Return: {
+                            index = add(flat.returns, visit(static_cast<const ASTReturn *>(node)->expr));
+                            break;
+                        }
+
+                        case ASTType::Block: {
+                            auto block = static_cast<const ASTBlock *>(node);
+
+                            std::vector<NodeId> nodes;
+                            for (auto child : block->nodes) {
+                                nodes.push_back(visit(child));
+                            }
+
+                            index = add(flat.blocks, FlatBlock { visit(block->parent), span(nodes) });
+                            break;
+                        }
+
+                        case ASTType::FunctionHeader: {
+                            auto header = static_cast<const ASTFunctionHeader *>(node);
+
+                            std::vector<NodeId> paramDecls;
+                            for (auto paramDecl : header->paramDecls) {
+                                paramDecls.push_back(visit(paramDecl));
+                            }
+
+                            NodeId name = visit(header->name);
+                            FlatType rt = type(header->rt);
+                            FlatSpan params = span(paramDecls);
+
+                            index = add(flat.functionHeaders, FlatFunctionHeader { name, visit(header->body), params, rt, header->flags });
+                            break;
+                        }
+
+                        case ASTType::FunctionBody: {
+                            // A skimmed body is parsed now; the flat form has no way to say "not parsed yet".
+                            auto body = const_cast<ASTFunctionBody *>(static_cast<const ASTFunctionBody *>(node));
+                            index = add(flat.functionBodies, FlatPair { visit(body->header), visit(body->getBlock()) });
+                            break;
+                        }
+
+                        case ASTType::While: {
+                            auto whileStatement = static_cast<const ASTWhile *>(node);
+                            index = add(flat.whiles, FlatPair { visit(whileStatement->condition), visit(whileStatement->statement) });
+                            break;
+                        }
+
+                        case ASTType::For: {
+                            auto forStatement = static_cast<const ASTFor *>(node);
+                            index = add(flat.fors, FlatPair { visit(forStatement->expr), visit(forStatement->statement) });
+                            break;
+                        }
+
+                        case ASTType::Range: {
+                            auto range = static_cast<const ASTRange *>(node);
+                            index = add(flat.ranges, FlatPair { visit(range->lower), visit(range->upper) });
+                            break;
+                        }
+
+                        case ASTType::Continue:
+                        case ASTType::Break:
+                            break;
+
+                        case ASTType::If: {
+                            auto ifStatement = static_cast<const ASTIf *>(node);
+
+                            NodeId condition = visit(ifStatement->condition);
+                            NodeId statement = visit(ifStatement->statement);
+
+                            std::vector<NodeId> elifs;
+                            for (auto &elif : ifStatement->elifs) {
+                                elifs.push_back(visit(elif.first));
+                                elifs.push_back(visit(elif.second));
+                            }
+
+                            FlatSpan elifSpan = span(elifs);
+                            index = add(flat.ifs, FlatIf { condition, statement, elifSpan, visit(ifStatement->elseStatement) });
+                            break;
+                        }
+
+                        case ASTType::Expression: {
+                            auto expr = static_cast<const ASTExpression *>(node);
+                            exprType = (std::uint8_t)expr->getExprType();
+
+                            switch (expr->getExprType()) {
+                                case ASTExpression::Type::Ref: {
+                                    index = add(flat.refs, visit(static_cast<const ASTRef *>(expr)->node));
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Call: {
+                                    auto call = static_cast<const ASTCall *>(expr);
+
+                                    NodeId called = visit(call->called);
+
+                                    std::vector<NodeId> callArgs;
+                                    for (auto arg : call->callArgs) {
+                                        callArgs.push_back(visit(arg));
+                                    }
+
+                                    index = add(flat.calls, FlatCall { called, span(callArgs) });
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Subscript: {
+                                    auto subscript = static_cast<const ASTSubscript *>(expr);
+                                    index = add(flat.subscripts, FlatPair { visit(subscript->indexed), visit(subscript->index) });
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Literal: {
+                                    auto lit = static_cast<const ASTLiteral *>(expr);
+                                    detail = (std::uint8_t)lit->literalType;
+
+                                    FlatLiteral record { 0, {} };
+
+                                    switch (lit->literalType) {
+                                        case ASTLiteral::Type::Integer:
+                                            record.bits = lit->getInteger();
+                                            break;
+
+                                        case ASTLiteral::Type::Decimal: {
+                                            double value = lit->getDecimal();
+                                            std::memcpy(&record.bits, &value, sizeof(value));
+                                            break;
+                                        }
+
+                                        case ASTLiteral::Type::Bool:
+                                            record.bits = lit->getBool();
+                                            break;
+
+                                        case ASTLiteral::Type::Name:
+                                        case ASTLiteral::Type::String:
+                                        case ASTLiteral::Type::Character:
+                                            record.text = text(lit->getString());
+                                            break;
+                                    }
+
+                                    index = add(flat.literals, record);
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Conversion: {
+                                    auto conversion = static_cast<const ASTConversion *>(expr);
+
+                                    NodeId from = visit(conversion->from);
+                                    index = add(flat.conversions, FlatConversion { from, type(conversion->to) });
+                                    break;
+                                }
+
+                                case ASTExpression::Type::UnaryOperator: {
+                                    auto unop = static_cast<const ASTUnaryOperator *>(expr);
+                                    detail = (std::uint8_t)unop->unopType;
+                                    index = add(flat.unaryOperators, visit(unop->node));
+                                    break;
+                                }
+
+                                case ASTExpression::Type::BinaryOperator: {
+                                    auto binop = static_cast<const ASTBinaryOperator *>(expr);
+                                    detail = (std::uint8_t)binop->binopType;
+
+                                    NodeId left = visit(binop->left);
+                                    index = add(flat.binaryOperators, FlatPair { left, visit(binop->right) });
+                                    break;
+                                }
+                            }
+
+                            break;
+                        }
+
+                        case ASTType::StructureDescription: {
+                            auto description = static_cast<const ASTStructureDescription *>(node);
+
+                            NodeId name = visit(description->name);
+
+                            std::vector<NodeId> members;
+                            for (auto member : description->members) {
+                                members.push_back(visit(member));
+                            }
+
+                            index = add(flat.structureDescriptions, FlatStructureDescription { name, span(members) });
+                            break;
+                        }
+                    }
+
+                    // Visiting the children may have grown flat.nodes, so don't hold on to a reference across them.
+                    flat.nodes[id].exprType = exprType;
+                    flat.nodes[id].detail = detail;
+                    flat.nodes[id].index = index;
+
+                    return id;
+                }
+            };
+
+            class Expander {
+            private:
+                const FlatAST &flat;
+                std::vector<ASTNode *> made; // Indexed by NodeId.
+
+                std::uint32_t limit = 0; // Largest offset a location can have: the size of the file at flat.base, plus one for where Eoi sits.
+
+                [[noreturn]] void malformed() {
+                    throw std::runtime_error("malformed flat AST.");
+                }
+
+                // A kind or operator byte read back from the file; anything past the enum's last value would fall through every switch on it later.
+                template<typename E>
+                E checked(std::uint8_t value, E last) {
+                    if (value > (std::uint8_t)last) malformed();
+                    return (E)value;
+                }
+
+                const FlatNode &at(NodeId id) {
+                    if (id >= flat.nodes.size()) malformed();
+                    return flat.nodes[id];
+                }
+
+                ASTNode *get(NodeId id) {
+                    if (id == NoNode) return nullptr;
+                    if (id >= made.size()) malformed();
+                    return made[id];
+                }
+
+                template<typename T>
+                T *get(NodeId id, ASTType type) {
+                    if (id == NoNode) return nullptr;
+                    if (at(id).type != (std::uint8_t)type) malformed();
+                    return static_cast<T *>(made[id]);
+                }
+
+                template<typename T>
+                const T &record(const std::vector<T> &array, const FlatNode &node) {
+                    if (node.index >= array.size()) malformed();
+                    return array[node.index];
+                }
+
+                std::vector<NodeId> ids(const FlatSpan &span) {
+                    if ((std::uint64_t)span.first + span.count > flat.children.size()) malformed();
+                    return std::vector<NodeId>(flat.children.begin() + span.first, flat.children.begin() + span.first + span.count);
+                }
+
+                Type type(const FlatType &type) {
+                    return Type(get(type.baseType), type.pointer);
+                }
+
+                core::SourceLocation location(std::uint32_t offset) {
+                    if (offset > limit) malformed();
+                    return offset ? core::SourceLocation(flat.base + offset - 1) : core::SourceLocation();
+                }
+
+                ASTNode *create(Module &module, const FlatNode &node) {
+                    switch (checked(node.type, ASTType::StructureDescription)) {
+                        case ASTType::BuiltinType:
+                            return module.make<ASTBuiltinType>(checked(node.detail, ASTBuiltinType::Type::FunctionPrototype));
+
+                        case ASTType::VariableDeclaration: {
+                            auto decl = module.make<ASTVariableDeclaration>(nullptr, Type(nullptr, 0));
+                            decl->flags = record(flat.variableDeclarations, node).flags;
+                            return decl;
+                        }
+
+                        case ASTType::VariableDefinition:
+                            return module.make<ASTVariableDefinition>(nullptr, nullptr);
+
+                        case ASTType::Return:
+                            return module.make<ASTReturn>(nullptr);
+
+                        case ASTType::Block:
+                            return module.make<ASTBlock>(std::vector<ASTNode *>());
+
+                        case ASTType::FunctionHeader: {
+                            auto header = module.make<ASTFunctionHeader>();
+                            header->flags = record(flat.functionHeaders, node).flags;
+                            return header;
+                        }
+
+                        case ASTType::FunctionBody:
+                            return module.make<ASTFunctionBody>();
+
+                        case ASTType::While:
+                            return module.make<ASTWhile>(nullptr, nullptr);
+
+                        case ASTType::For:
+                            return module.make<ASTFor>(nullptr, nullptr);
+
+                        case ASTType::Range:
+                            return module.make<ASTRange>(nullptr, nullptr);
+
+                        case ASTType::Continue:
+                            return module.make<ASTContinue>();
+
+                        case ASTType::Break:
+                            return module.make<ASTBreak>();
+
+                        case ASTType::If:
+                            return module.make<ASTIf>(nullptr, nullptr, std::vector<std::pair<ASTNode *, ASTNode *>>(), nullptr);
+
+                        case ASTType::Expression:
+                            switch (checked(node.exprType, ASTExpression::Type::BinaryOperator)) {
+                                case ASTExpression::Type::Ref:
+                                    return module.make<ASTRef>(nullptr);
+
+                                case ASTExpression::Type::Call:
+                                    return module.make<ASTCall>(nullptr, std::vector<ASTNode *>());
+
+                                case ASTExpression::Type::Subscript:
+                                    return module.make<ASTSubscript>(nullptr, nullptr);
+
+                                case ASTExpression::Type::Literal: {
+                                    auto &lit = record(flat.literals, node);
+
+                                    if ((std::uint64_t)lit.text.first + lit.text.count > flat.strings.size()) malformed();
+                                    std::string_view text(flat.strings.data() + lit.text.first, lit.text.count);
+
+                                    switch (checked(node.detail, ASTLiteral::Type::Bool)) {
+                                        case ASTLiteral::Type::Integer:
+                                            return module.make<ASTLiteral>(lit.bits);
+
+                                        case ASTLiteral::Type::Decimal: {
+                                            double value;
+                                            std::memcpy(&value, &lit.bits, sizeof(value));
+                                            return module.make<ASTLiteral>(value);
+                                        }
+
+                                        case ASTLiteral::Type::Bool:
+                                            return module.make<ASTLiteral>(lit.bits != 0);
+
+                                        case ASTLiteral::Type::Name:
+                                        case ASTLiteral::Type::String:
+                                        case ASTLiteral::Type::Character:
+                                            return module.make<ASTLiteral>(text, checked(node.detail, ASTLiteral::Type::Bool));
+                                    }
+
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Conversion:
+                                    return module.make<ASTConversion>(nullptr, Type(nullptr, 0));
+
+                                case ASTExpression::Type::UnaryOperator:
+                                    return module.make<ASTUnaryOperator>(checked(node.detail, ASTUnaryOperator::Type::AddressOf), nullptr);
+
+                                case ASTExpression::Type::BinaryOperator:
+                                    return module.make<ASTBinaryOperator>(checked(node.detail, ASTBinaryOperator::Type::Assign), nullptr, nullptr);
+                            }
+
+                            break;
+
+                        case ASTType::StructureDescription:
+                            return module.make<ASTStructureDescription>(nullptr, std::vector<ASTVariableDeclaration *>());
+                    }
+
+                    malformed();
+                }
+
+                void link(ASTNode *result, const FlatNode &node) {
+                    switch (checked(node.type, ASTType::StructureDescription)) {
+                        case ASTType::BuiltinType: {
+                            auto builtinType = static_cast<ASTBuiltinType *>(result);
+
+                            if (builtinType->builtinType == ASTBuiltinType::Type::FunctionPrototype) {
+                                auto &bt = record(flat.builtinTypes, node);
+                                builtinType->fpData.rt = type(bt.rt);
+
+                                if ((std::uint64_t)bt.paramTypes.first + bt.paramTypes.count > flat.types.size()) malformed();
+                                for (std::uint32_t i = 0; i < bt.paramTypes.count; i++) {
+                                    builtinType->fpData.paramTypes.push_back(type(flat.types[bt.paramTypes.first + i]));
+                                }
+                            }
+
+                            break;
+                        }
+
+                        case ASTType::VariableDeclaration: {
+                            auto decl = static_cast<ASTVariableDeclaration *>(result);
+                            auto &vd = record(flat.variableDeclarations, node);
+
+                            decl->name = get(vd.name);
+                            decl->targetTy = type(vd.targetTy);
+                            break;
+                        }
+
+                        case ASTType::VariableDefinition: {
+                            auto defn = static_cast<ASTVariableDefinition *>(result);
+                            auto &pair = record(flat.variableDefinitions, node);
+
+                            defn->decl = get<ASTVariableDeclaration>(pair.first, ASTType::VariableDeclaration);
+                            defn->expr = get(pair.second);
+                            break;
+                        }
+
+                        case ASTType::Return:
+                            static_cast<ASTReturn *>(result)->expr = get(record(flat.returns, node));
+                            break;
+
+                        case ASTType::Block: {
+                            auto block = static_cast<ASTBlock *>(result);
+                            auto &fb = record(flat.blocks, node);
+
+                            block->parent = get<ASTBlock>(fb.parent, ASTType::Block);
+                            for (auto id : ids(fb.nodes)) {
+                                block->nodes.push_back(get(id));
+                            }
+
+                            break;
+                        }
+
+                        case ASTType::FunctionHeader: {
+                            auto header = static_cast<ASTFunctionHeader *>(result);
+                            auto &fh = record(flat.functionHeaders, node);
+
+                            header->name = get(fh.name);
+                            header->body = get<ASTFunctionBody>(fh.body, ASTType::FunctionBody);
+                            header->rt = type(fh.rt);
+
+                            for (auto id : ids(fh.paramDecls)) {
+                                header->paramDecls.push_back(get<ASTVariableDeclaration>(id, ASTType::VariableDeclaration));
+                            }
+
+                            break;
+                        }
+
+                        case ASTType::FunctionBody: {
+                            auto body = static_cast<ASTFunctionBody *>(result);
+                            auto &pair = record(flat.functionBodies, node);
+
+                            body->header = get<ASTFunctionHeader>(pair.first, ASTType::FunctionHeader);
+                            body->block = get<ASTBlock>(pair.second, ASTType::Block);
+                            break;
+                        }
+
+                        case ASTType::While: {
+                            auto whileStatement = static_cast<ASTWhile *>(result);
+                            auto &pair = record(flat.whiles, node);
+
+                            whileStatement->condition = get(pair.first);
+                            whileStatement->statement = get(pair.second);
+                            break;
+                        }
+
+                        case ASTType::For: {
+                            auto forStatement = static_cast<ASTFor *>(result);
+                            auto &pair = record(flat.fors, node);
+
+                            forStatement->expr = get(pair.first);
+                            forStatement->statement = get(pair.second);
+                            break;
+                        }
+
+                        case ASTType::Range: {
+                            auto range = static_cast<ASTRange *>(result);
+                            auto &pair = record(flat.ranges, node);
+
+                            range->lower = get(pair.first);
+                            range->upper = get(pair.second);
+                            break;
+                        }
+
+                        case ASTType::Continue:
+                        case ASTType::Break:
+                            break;
+
+                        case ASTType::If: {
+                            auto ifStatement = static_cast<ASTIf *>(result);
+                            auto &fi = record(flat.ifs, node);
+
+                            ifStatement->condition = get(fi.condition);
+                            ifStatement->statement = get(fi.statement);
+                            ifStatement->elseStatement = get(fi.elseStatement);
+
+                            auto elifs = ids(fi.elifs);
+                            if (elifs.size() % 2) malformed();
+
+                            for (std::size_t i = 0; i < elifs.size(); i += 2) {
+                                ifStatement->elifs.emplace_back(get(elifs[i]), get(elifs[i + 1]));
+                            }
+
+                            break;
+                        }
+
+                        case ASTType::Expression:
+                            switch (checked(node.exprType, ASTExpression::Type::BinaryOperator)) {
+                                case ASTExpression::Type::Ref:
+                                    static_cast<ASTRef *>(result)->node = get(record(flat.refs, node));
+                                    break;
+
+                                case ASTExpression::Type::Call: {
+                                    auto call = static_cast<ASTCall *>(result);
+                                    auto &fc = record(flat.calls, node);
+
+                                    call->called = get(fc.called);
+                                    for (auto id : ids(fc.callArgs)) {
+                                        call->callArgs.push_back(get(id));
+                                    }
+
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Subscript: {
+                                    auto subscript = static_cast<ASTSubscript *>(result);
+                                    auto &pair = record(flat.subscripts, node);
+
+                                    subscript->indexed = get(pair.first);
+                                    subscript->index = get(pair.second);
+                                    break;
+                                }
+
+                                case ASTExpression::Type::Literal:
+                                    break;
+
+                                case ASTExpression::Type::Conversion: {
+                                    auto conversion = static_cast<ASTConversion *>(result);
+                                    auto &fc = record(flat.conversions, node);
+
+                                    conversion->from = get(fc.from);
+                                    conversion->to = type(fc.to);
+                                    break;
+                                }
+
+                                case ASTExpression::Type::UnaryOperator:
+                                    static_cast<ASTUnaryOperator *>(result)->node = get(record(flat.unaryOperators, node));
+                                    break;
+
+                                case ASTExpression::Type::BinaryOperator: {
+                                    auto binop = static_cast<ASTBinaryOperator *>(result);
+                                    auto &pair = record(flat.binaryOperators, node);
+
+                                    binop->left = get(pair.first);
+                                    binop->right = get(pair.second);
+                                    break;
+                                }
+                            }
+
+                            break;
+
+                        case ASTType::StructureDescription: {
+                            auto description = static_cast<ASTStructureDescription *>(result);
+                            auto &sd = record(flat.structureDescriptions, node);
+
+                            description->name = get(sd.name);
+                            for (auto id : ids(sd.members)) {
+                                description->members.push_back(get<ASTVariableDeclaration>(id, ASTType::VariableDeclaration));
+                            }
+
+                            break;
+                        }
+                    }
+                }
+            public:
+                Expander(const FlatAST &flat) : flat(flat) {
+                    if (auto buffer = core::SourceManager::global().getBuffer(core::SourceLocation(flat.base))) {
+                        limit = (std::uint32_t)buffer->getSource().size() + 1;
+                    }
+                }
+
+                void run(Module &module) {
+                    // Every node is made before any is linked, since bodies, parents and refs point at nodes numbered before them.
+                    made.reserve(flat.nodes.size());
+
+                    for (auto &node : flat.nodes) {
+                        ASTNode *result = create(module, node);
+                        result->begin = location(node.begin);
+                        result->end = location(node.end);
+
+                        made.push_back(result);
+                    }
+
+                    for (std::size_t i = 0; i < made.size(); i++) {
+                        link(made[i], flat.nodes[i]);
+                    }
+
+                    for (auto id : flat.roots) {
+                        if (id == NoNode) malformed();
+                        module.nodes.push_back(get(id));
+                    }
+                }
+            };
+        }
+
+        template<typename Self, typename F>
+        void FlatAST::forEachArray(Self &self, F &&f) {
+            f(self.nodes);
+            f(self.roots);
+            f(self.children);
+            f(self.types);
+            f(self.strings);
+
+            f(self.builtinTypes);
+            f(self.variableDeclarations);
+            f(self.variableDefinitions);
+            f(self.returns);
+            f(self.blocks);
+            f(self.functionHeaders);
+            f(self.functionBodies);
+            f(self.whiles);
+            f(self.fors);
+            f(self.ranges);
+            f(self.ifs);
+            f(self.refs);
+            f(self.calls);
+            f(self.subscripts);
+            f(self.literals);
+            f(self.conversions);
+            f(self.unaryOperators);
+            f(self.binaryOperators);
+            f(self.structureDescriptions);
+        }
+
+        FlatAST FlatAST::flatten(const Module &module) {
+            FlatAST flat;
+            flat.nodes.reserve(module.getNodeCount());
+
+            if (!module.nodes.empty()) {
+                if (auto buffer = core::SourceManager::global().getBuffer(module.nodes.front()->begin)) {
+                    flat.base = buffer->getBase();
+                }
+            }
+
+            Flattener flattener(flat, module.getNodeCount());
+
+            for (auto node : module.nodes) {
+                flat.roots.push_back(flattener.visit(node));
+            }
+
+            return flat;
+        }
+
+        void FlatAST::expand(Module &module) const {
+            Expander(*this).run(module);
+        }
+
+        std::size_t FlatAST::getSize() const {
+            std::size_t size = sizeof(magic) + sizeof(version);
+
+            forEachArray(*this, [&](const auto &array) {
+                size += sizeof(std::uint64_t) + array.size() * sizeof(array[0]);
+            });
+
+            return size;
+        }
+
+        std::vector<char> FlatAST::serialize() const {
+            std::vector<char> bytes(getSize());
+            char *cursor = bytes.data();
+
+            auto put = [&](const void *data, std::size_t size) {
+                if (size) std::memcpy(cursor, data, size);
+                cursor += size;
+            };
+
+            put(magic, sizeof(magic));
+            put(&version, sizeof(version));
+
+            forEachArray(*this, [&](const auto &array) {
+                static_assert(std::is_trivially_copyable_v<std::decay_t<decltype(array[0])>>);
+
+                std::uint64_t count = array.size();
+                put(&count, sizeof(count));
+                put(array.data(), array.size() * sizeof(array[0]));
+            });
+
+            return bytes;
+        }
+
+        FlatAST FlatAST::deserialize(std::string_view bytes) {
+            FlatAST flat;
+
+            auto take = [&](void *data, std::uint64_t size) {
+                if (size > bytes.size()) {
+                    throw std::runtime_error("truncated flat AST.");
+                }
+
+                if (size) std::memcpy(data, bytes.data(), size);
+                bytes.remove_prefix(size);
+            };
+
+            char fileMagic[sizeof(magic)];
+            std::uint32_t fileVersion;
+
+            take(fileMagic, sizeof(fileMagic));
+            take(&fileVersion, sizeof(fileVersion));
+
+            if (std::memcmp(fileMagic, magic, sizeof(magic)) || fileVersion != version) {
+                throw std::runtime_error(fmt::format("not a flat AST (or not version {}).", version));
+            }
+
+            forEachArray(flat, [&](auto &array) {
+                std::uint64_t count;
+                take(&count, sizeof(count));
+
+                if (count > bytes.size() / sizeof(array[0])) {
+                    throw std::runtime_error("truncated flat AST.");
+                }
+
+                array.resize(count);
+                take(array.data(), count * sizeof(array[0]));
+            });
+
+            return flat;
+        }
+    }
+}
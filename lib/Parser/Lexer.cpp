@@ -1,59 +1,364 @@
 #include "rtl/Parser/Lexer.h"
+#include "rtl/Core/Scan.h"
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 
 namespace rtl {
     namespace parser {
-        void Lexer::next() {
-            if (source[sourceLocation.pointer++] == '\n') {
-                ++sourceLocation.line;
-                sourceLocation.lexpos = 1;
-            } else {
-                ++sourceLocation.lexpos;
+        namespace {
+            struct Keyword {
+                std::string_view text;
+                TokenType type;
+            };
+
+            constexpr Keyword keywords[] = {
+                { "i8", TokenType::KwI8 }, { "u8", TokenType::KwU8 }, { "as", TokenType::KwAs }, { "if", TokenType::KwIf },
+
+                { "val", TokenType::KwVal }, { "var", TokenType::KwVar }, { "pub", TokenType::KwPub }, { "fun", TokenType::KwFun }, { "any", TokenType::KwAny },
+                { "i16", TokenType::KwI16 }, { "i32", TokenType::KwI32 }, { "i64", TokenType::KwI64 },
+                { "u16", TokenType::KwU16 }, { "u32", TokenType::KwU32 }, { "u64", TokenType::KwU64 },
+                { "f32", TokenType::KwF32 }, { "f64", TokenType::KwF64 }, { "for", TokenType::KwFor },
+
+                { "none", TokenType::KwNone }, { "bool", TokenType::KwBool }, { "true", TokenType::KwTrue },
+                { "elif", TokenType::KwElif }, { "else", TokenType::KwElse }, { "enum", TokenType::KwEnum },
+
+                { "false", TokenType::KwFalse },
+                { "usize", TokenType::KwU64 }, // Maybe I should make these platform-specific? idek.
+                { "isize", TokenType::KwI64 }, // Maybe I should make these platform-specific? idek.
+                { "while", TokenType::KwWhile }, { "break", TokenType::KwBreak }, { "union", TokenType::KwUnion },
+
+                { "import", TokenType::KwImport }, { "switch", TokenType::KwSwitch }, { "struct", TokenType::KwStruct }, { "return", TokenType::KwReturn },
+                { "size_of", TokenType::KwSizeOf },
+                { "continue", TokenType::KwContinue },
+                { "namespace", TokenType::KwNamespace }
+            };
+
+            constexpr std::size_t minKeywordLength = 2, maxKeywordLength = 9;
+
+            // Every keyword lands in its own slot of a 128-entry table, so classifying a word is one hash and (at most) one compare.
+            // The hash only looks at the first two bytes, the last byte and the length; the two multipliers are searched for at compile time.
+            constexpr std::size_t keywordTableSize = 128;
+
+            constexpr std::size_t hashWord(const std::string_view &word, std::size_t m1, std::size_t m2) {
+                return ((std::size_t)(unsigned char)word[0] + (std::size_t)(unsigned char)word[1] * m1 + (std::size_t)(unsigned char)word[word.size() - 1] * m2 + word.size()) & (keywordTableSize - 1);
+            }
+
+            constexpr bool isPerfect(std::size_t m1, std::size_t m2) {
+                bool used[keywordTableSize] {};
+
+                for (const auto &keyword : keywords) {
+                    std::size_t hash = hashWord(keyword.text, m1, m2);
+
+                    if (used[hash]) {
+                        return false;
+                    }
+
+                    used[hash] = true;
+                }
+
+                return true;
+            }
+
+            struct Multipliers {
+                std::size_t m1, m2;
+            };
+
+            constexpr Multipliers findMultipliers() {
+                for (std::size_t m1 = 1; m1 < 64; m1++) {
+                    for (std::size_t m2 = 1; m2 < 64; m2++) {
+                        if (isPerfect(m1, m2)) {
+                            return { m1, m2 };
+                        }
+                    }
+                }
+
+                return { 0, 0 };
+            }
+
+            constexpr Multipliers multipliers = findMultipliers();
+            static_assert(multipliers.m1 != 0, "no perfect hash for the keyword set; widen the search or grow keywordTableSize.");
+
+            struct KeywordTable {
+                Keyword slots[keywordTableSize] {};
+
+                constexpr KeywordTable() {
+                    for (const auto &keyword : keywords) {
+                        slots[hashWord(keyword.text, multipliers.m1, multipliers.m2)] = keyword;
+                    }
+                }
+            };
+
+            constexpr KeywordTable keywordTable;
+
+            bool isBinaryDigit(char c) {
+                return c == '0' || c == '1';
+            }
+
+            bool isOctalDigit(char c) {
+                return c >= '0' && c <= '7';
+            }
+
+            bool isDecimalDigit(char c) {
+                return c >= '0' && c <= '9';
+            }
+
+            bool isHexDigit(char c) {
+                return isDecimalDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            }
+
+            std::uint64_t hexDigitValue(char c) {
+                if (c <= '9') return c - '0';
+                return 10 + ((c | 0x20) - 'a');
+            }
+
+            // SWAR: true if all 8 bytes of `chunk` are '0'..'9'.
+            bool isEightDigits(std::uint64_t chunk) {
+                return ((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+            }
+
+            // SWAR: the value of 8 ASCII digits loaded little-endian (first digit in the lowest byte).
+            std::uint64_t parseEightDigits(std::uint64_t chunk) {
+                chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+                chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+                return ((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+            }
+
+            bool isLittleEndian() {
+                const std::uint16_t probe = 1;
+                return *(const std::uint8_t *)&probe == 1;
+            }
+
+            struct Operator {
+                std::string_view text;
+                TokenType type;
+            };
+
+            // Every operator there is; matchOperator() is checked against this list at compile time.
+            constexpr Operator operators[] = {
+                { "(", TokenType::LeftParen }, { ")", TokenType::RightParen },
+                { "[", TokenType::LeftBracket }, { "]", TokenType::RightBracket },
+                { "{", TokenType::LeftBrace }, { "}", TokenType::RightBrace },
+
+                { ".", TokenType::Dot }, { "..", TokenType::DotDot },
+                { ",", TokenType::Comma },
+                { "$", TokenType::Dollar },
+                { ";", TokenType::SemiColon },
+                { ":", TokenType::Colon }, { "::", TokenType::ColonColon },
+
+                { "+", TokenType::Add }, { "+=", TokenType::AddEqual },
+                { "-", TokenType::Subtract }, { "-=", TokenType::SubtractEqual }, { "->", TokenType::Arrow },
+                { "%", TokenType::Modulo }, { "%=", TokenType::ModuloEqual },
+                { "*", TokenType::Multiply }, { "*=", TokenType::MultiplyEqual },
+                { "/", TokenType::Divide }, { "/=", TokenType::DivideEqual },
+
+                { "&", TokenType::BitAnd }, { "&=", TokenType::BitAndEqual }, { "&&", TokenType::LogicalAnd },
+                { "^", TokenType::BitXor }, { "^=", TokenType::BitXorEqual },
+                { "|", TokenType::BitOr }, { "|=", TokenType::BitOrEqual }, { "||", TokenType::LogicalOr },
+                { "~", TokenType::BitNot },
+
+                { "<", TokenType::LogicalLessThan }, { "<=", TokenType::LogicalLessThanEqual }, { "<<", TokenType::BitShiftLeft }, { "<<=", TokenType::BitShiftLeftEqual },
+                { ">", TokenType::LogicalGreaterThan }, { ">=", TokenType::LogicalGreaterThanEqual }, { ">>", TokenType::BitShiftRight }, { ">>=", TokenType::BitShiftRightEqual },
+
+                { "=", TokenType::Equal }, { "==", TokenType::LogicalEqual }, { "=>", TokenType::BigArrow },
+                { "!", TokenType::LogicalNot }, { "!=", TokenType::LogicalNotEqual }
+            };
+
+            struct OperatorMatch {
+                TokenType type = TokenType::Invalid;
+                std::size_t length = 0; // 0 if 'text' doesn't start with an operator.
+            };
+
+            // The longest operator at the front of 'text'. GCC compiles the outer switch to a jump table on the first byte, which the branch predictor handles
+            // well; a generated two-byte lookup table was a few percent slower on operator-dense code (rtlbench operators).
+            constexpr OperatorMatch matchOperator(std::string_view text) {
+                char second = text.size() > 1 ? text[1] : '\0';
+                char third = text.size() > 2 ? text[2] : '\0';
+
+                // 'plain', or 'equal' if it's followed by '='.
+                auto orEqual = [&](TokenType plain, TokenType equal) {
+                    return second == '=' ? OperatorMatch { equal, 2 } : OperatorMatch { plain, 1 };
+                };
+
+                switch (text.empty() ? '\0' : text[0]) {
+                    case '(': return { TokenType::LeftParen, 1 };
+                    case ')': return { TokenType::RightParen, 1 };
+                    case '[': return { TokenType::LeftBracket, 1 };
+                    case ']': return { TokenType::RightBracket, 1 };
+                    case '{': return { TokenType::LeftBrace, 1 };
+                    case '}': return { TokenType::RightBrace, 1 };
+
+                    case '.': return second == '.' ? OperatorMatch { TokenType::DotDot, 2 } : OperatorMatch { TokenType::Dot, 1 };
+                    case ',': return { TokenType::Comma, 1 };
+                    case '$': return { TokenType::Dollar, 1 };
+                    case ';': return { TokenType::SemiColon, 1 };
+                    case ':': return second == ':' ? OperatorMatch { TokenType::ColonColon, 2 } : OperatorMatch { TokenType::Colon, 1 };
+
+                    case '+': return orEqual(TokenType::Add, TokenType::AddEqual);
+                    case '-': return second == '>' ? OperatorMatch { TokenType::Arrow, 2 } : orEqual(TokenType::Subtract, TokenType::SubtractEqual);
+                    case '%': return orEqual(TokenType::Modulo, TokenType::ModuloEqual);
+                    case '*': return orEqual(TokenType::Multiply, TokenType::MultiplyEqual);
+                    case '/': return orEqual(TokenType::Divide, TokenType::DivideEqual);
+
+                    case '&': return second == '&' ? OperatorMatch { TokenType::LogicalAnd, 2 } : orEqual(TokenType::BitAnd, TokenType::BitAndEqual);
+                    case '^': return orEqual(TokenType::BitXor, TokenType::BitXorEqual);
+                    case '|': return second == '|' ? OperatorMatch { TokenType::LogicalOr, 2 } : orEqual(TokenType::BitOr, TokenType::BitOrEqual);
+                    case '~': return { TokenType::BitNot, 1 };
+
+                    case '<': {
+                        if (second == '<') {
+                            return third == '=' ? OperatorMatch { TokenType::BitShiftLeftEqual, 3 } : OperatorMatch { TokenType::BitShiftLeft, 2 };
+                        }
+
+                        return orEqual(TokenType::LogicalLessThan, TokenType::LogicalLessThanEqual);
+                    }
+
+                    case '>': {
+                        if (second == '>') {
+                            return third == '=' ? OperatorMatch { TokenType::BitShiftRightEqual, 3 } : OperatorMatch { TokenType::BitShiftRight, 2 };
+                        }
+
+                        return orEqual(TokenType::LogicalGreaterThan, TokenType::LogicalGreaterThanEqual);
+                    }
+
+                    case '=': return second == '>' ? OperatorMatch { TokenType::BigArrow, 2 } : orEqual(TokenType::Equal, TokenType::LogicalEqual);
+                    case '!': return orEqual(TokenType::LogicalNot, TokenType::LogicalNotEqual);
+
+                    default: return {};
+                }
+            }
+
+            constexpr bool isOperator(std::string_view text, TokenType type) {
+                for (const auto &op : operators) {
+                    if (op.text == text) {
+                        return op.type == type;
+                    }
+                }
+
+                return false;
+            }
+
+            // Every operator in the list lexes as itself, and whatever byte follows a listed operator (or starts the input), matchOperator() only ever finds listed ones.
+            constexpr bool matchesOperators() {
+                for (const auto &op : operators) {
+                    auto match = matchOperator(op.text);
+
+                    if (match.type != op.type || match.length != op.text.size()) {
+                        return false;
+                    }
+                }
+
+                for (std::size_t i = 0; i <= std::size(operators); i++) {
+                    std::string_view prefix = i < std::size(operators) ? operators[i].text : std::string_view();
+
+                    for (int c = 0; c < 256; c++) {
+                        char text[4] {};
+
+                        for (std::size_t j = 0; j < prefix.size(); j++) {
+                            text[j] = prefix[j];
+                        }
+
+                        text[prefix.size()] = (char)c;
+
+                        // A match no longer than the prefix is the prefix itself, which the first loop already checked.
+                        auto match = matchOperator(std::string_view(text, prefix.size() + 1));
+                        if (match.length > prefix.size() && !isOperator(std::string_view(text, match.length), match.type)) {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            static_assert(matchesOperators(), "matchOperator() has to agree with the operator list.");
+
+            // Bytes skipBraces() has to stop at; everything else is skipped without a second look.
+            struct SkimTable {
+                bool stops[256] {};
+
+                constexpr SkimTable() {
+                    for (char c : std::string_view("{}\"'#/")) {
+                        stops[(unsigned char)c] = true;
+                    }
+                }
+            };
+
+            constexpr SkimTable skimTable;
+
+            bool isLiteral(TokenType type) {
+                return type == TokenType::Integer || type == TokenType::Decimal || type == TokenType::String || type == TokenType::Character;
+            }
+
+            TokenType classifyWord(const std::string_view &word) {
+                if (word.size() < minKeywordLength || word.size() > maxKeywordLength) {
+                    return TokenType::Name;
+                }
+
+                const Keyword &keyword = keywordTable.slots[hashWord(word, multipliers.m1, multipliers.m2)];
+
+                if (keyword.text.size() == word.size() && std::memcmp(keyword.text.data(), word.data(), word.size()) == 0) {
+                    return keyword.type;
+                }
+
+                return TokenType::Name;
             }
         }
 
+        core::SourceLocation Lexer::locate(std::uint32_t offset) const {
+            return core::SourceLocation(base + offset);
+        }
+
+        void Lexer::next() {
+            ++cursor;
+        }
+
         void Lexer::skip() {
             for (;;) {
-                while (sourceLocation.pointer < source.size() && std::isspace(source[sourceLocation.pointer])) {
-                    next();
-                }
+                cursor = (std::uint32_t)core::skipBlanks(source, cursor);
 
-                if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '#') {
-                    while (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] != '\n') {
-                        next();
-                    }
+                if (cursor < source.size() && source[cursor] == '#') {
+                    const char *newline = (const char *)std::memchr(&source[cursor], '\n', source.size() - cursor);
+                    cursor = newline ? (std::uint32_t)(newline - source.data()) : (std::uint32_t)source.size();
 
                     continue;
                 }
 
-                if (sourceLocation.pointer + 1 < source.size() && source[sourceLocation.pointer] == '/' && source[sourceLocation.pointer + 1] == '#') {
-                    core::SourceLocation location = sourceLocation;
+                if (cursor + 1 < source.size() && source[cursor] == '/' && source[cursor + 1] == '#') {
+                    core::SourceLocation location = locate(cursor);
 
                     next();
                     next();
 
                     std::size_t balance = 1;
 
-                    while (sourceLocation.pointer < source.size() && balance) {
-                        if (sourceLocation.pointer + 1 < source.size() && source[sourceLocation.pointer] == '/' && source[sourceLocation.pointer + 1] == '#') {
+                    while (cursor < source.size() && balance) {
+                        // Jump to the next byte that could start a delimiter.
+                        cursor = (std::uint32_t)core::findEither(source, cursor, '/', '#');
+
+                        if (cursor + 1 < source.size() && source[cursor] == '/' && source[cursor + 1] == '#') {
                             next();
                             next();
 
                             ++balance;
-                        } else if (sourceLocation.pointer + 1 < source.size() && source[sourceLocation.pointer] == '#' && source[sourceLocation.pointer + 1] == '/') {
+                        } else if (cursor + 1 < source.size() && source[cursor] == '#' && source[cursor + 1] == '/') {
                             next();
                             next();
 
                             --balance;
-                        } else {
+                        } else if (cursor < source.size()) {
                             next();
                         }
                     }
 
                     if (balance) {
-                        throw core::Error(core::Error::Type::Lexical, source, location, sourceLocation,  "unterminated comment.");
+                        throw core::Error(core::Error::Type::Lexical, location, locate(cursor),  "unterminated comment.");
                     }
 
                     continue;
@@ -63,662 +368,613 @@ namespace rtl {
             }
         }
 
-        void Lexer::once() {
+        void Lexer::scan(Token &token) {
             skip();
 
-            Token token;
-            token.begin = sourceLocation;
-            token.text = std::string_view(token.text.data(), 0);
-            std::size_t start = sourceLocation.pointer;
+            token.begin = locate(cursor);
+            token.text = std::string_view();
+            std::size_t start = cursor;
 
-            if (sourceLocation.pointer >= source.size() || !source[sourceLocation.pointer]) {
+            if (cursor >= source.size() || !source[cursor]) {
                 token.type = TokenType::Eoi;
-                const char *EOI = "$EOF";
-                std::strcpy(textBuffer, EOI);
-                token.text = std::string_view(textBuffer, std::strlen(EOI));
+                token.text = "$EOF";
+            } else if (scanOperator(token)) {
+                // That's all there is to an operator.
             } else {
-                switch (source[sourceLocation.pointer]) {
-                    case '(': {
-                        next();
-                        token.type = TokenType::LeftParen;
+                switch (source[cursor]) {
+                    case '\'':
+                    case '"': {
+                        scanString(token);
                         break;
                     }
 
-                    case ')': {
-                        next();
-                        token.type = TokenType::RightParen;
-                        break;
-                    }
+                    default:
+                    if (std::isalpha(source[cursor]) || source[cursor] == '_') {
+                        std::size_t begin = cursor;
 
-                    case '[': {
-                        next();
-                        token.type = TokenType::LeftBracket;
-                        break;
-                    }
+                        while (cursor < source.size() && (std::isalnum(source[cursor]) || source[cursor] == '_')) {
+                            next();
+                        }
 
-                    case ']': {
-                        next();
-                        token.type = TokenType::RightBracket;
-                        break;
-                    }
+                        std::size_t length = cursor - begin;
 
-                    case '{': {
-                        next();
-                        token.type = TokenType::LeftBrace;
+                        token.type = classifyWord(std::string_view(&source[begin], length));
                         break;
-                    }
-
-                    case '}': {
-                        next();
-                        token.type = TokenType::RightBrace;
+                    } else if (std::isdigit(source[cursor])) {
+                        scanNumber(token);
+                    } else {
+                        throw core::Error(core::Error::Type::Lexical, locate(cursor), locate(cursor), "invalid token");
                         break;
                     }
+                }
+            }
 
-                    case '.': {
+            token.end = locate(cursor);
 
-                        next();
+            if (!token.text.data()) {
+                token.text = std::string_view(&source[start], token.text.size());
+            }
 
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '.') {
-                            next();
-                            token.type = TokenType::DotDot;
-                            break;
-                        }
+            if (!token.text.size()) {
+                token.text = std::string_view(token.text.data(), cursor - start);
+            }
+        }
 
-                        token.type = TokenType::Dot;
-                        break;
+        bool Lexer::scanOperator(Token &token) {
+            auto match = matchOperator(source.substr(cursor, 3));
+
+            if (!match.length) {
+                return false;
+            }
+
+            token.type = match.type;
+            cursor += (std::uint32_t)match.length;
+
+            return true;
+        }
+
+        void Lexer::scanString(Token &token) {
+            char delim = source[cursor];
+
+            core::SourceLocation location = locate(cursor);
+            next();
+
+            // Find the closing delimiter before decoding anything; a backslash always takes the byte after it along.
+            std::size_t end = cursor;
+            bool escaped = false;
+
+            for (;;) {
+                end = core::findEither(source, end, delim, '\\');
+
+                if (end >= source.size() || source[end] == delim) {
+                    break;
+                }
+
+                escaped = true;
+                end += 2;
+            }
+
+            if (end >= source.size()) {
+                cursor = (std::uint32_t)source.size();
+                throw core::Error(core::Error::Type::Lexical, location, locate(cursor), "unterminated literal.");
+            }
+
+            token.type = delim == '"' ? TokenType::String : TokenType::Character;
+
+            if (!escaped) {
+                // Nothing to decode, so just point into the source.
+                token.litrl = source.substr(cursor, end - cursor);
+
+                cursor = (std::uint32_t)end;
+                next();
+
+                return;
+            }
+
+            // Every escape is at least as long as what it decodes to, so the raw length is enough room.
+            char *decoded = (char *)strings->allocate(end - cursor, 1);
+            std::size_t length = 0;
+
+            auto hexEscape = [&](std::size_t digits, const char *message) {
+                core::SourceLocation begin = locate(cursor);
+                next();
+
+                if (cursor + digits > source.size()) {
+                    throw core::Error(core::Error::Type::Lexical, begin, locate(cursor), message);
+                }
+
+                std::uint32_t value = 0;
+
+                for (std::size_t i = 0; i < digits; i++) {
+                    char c = source[cursor];
+
+                    if (!isHexDigit(c)) {
+                        throw core::Error(core::Error::Type::Lexical, begin, locate(cursor), fmt::format("invalid hex digit '{}'.", c));
                     }
 
-                    case ',': {
+                    value = value * 16 + (std::uint32_t)hexDigitValue(c);
+                    next();
+                }
+
+                return std::make_pair(begin, value);
+            };
+
+            auto encode = [&](const core::SourceLocation &begin, std::uint32_t codepoint) {
+                if (codepoint < 0x80) {
+                    decoded[length++] = (char)codepoint;
+                } else if (codepoint < 0x800) {
+                    decoded[length++] = (char)(0xC0 | (codepoint >> 6));
+                    decoded[length++] = (char)(0x80 | (codepoint & 0x3F));
+                } else if (codepoint < 0x10000) {
+                    decoded[length++] = (char)(0xE0 | (codepoint >> 12));
+                    decoded[length++] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+                    decoded[length++] = (char)(0x80 | (codepoint & 0x3F));
+                } else if (codepoint < 0x110000) {
+                    decoded[length++] = (char)(0xF0 | (codepoint >> 18));
+                    decoded[length++] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+                    decoded[length++] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+                    decoded[length++] = (char)(0x80 | (codepoint & 0x3F));
+                } else {
+                    throw core::Error(core::Error::Type::Lexical, begin, locate(cursor), fmt::format("invalid code point U+{:X}.", codepoint));
+                }
+            };
+
+            while (cursor < end) {
+                if (source[cursor] != '\\') {
+                    // Copy everything up to the next escape in one go.
+                    const char *escape = (const char *)std::memchr(&source[cursor], '\\', end - cursor);
+                    std::size_t run = (escape ? (std::size_t)(escape - source.data()) : end) - cursor;
+
+                    std::memcpy(decoded + length, &source[cursor], run);
+                    length += run;
+                    cursor += (std::uint32_t)run;
+
+                    continue;
+                }
+
+                next();
+
+                switch (source[cursor]) {
+                    case 'f': {
                         next();
-                        token.type = TokenType::Comma;
+                        decoded[length++] = '\f';
                         break;
                     }
 
-                    case '$': {
+                    case 'n': {
                         next();
-                        token.type = TokenType::Dollar;
+                        decoded[length++] = '\n';
                         break;
                     }
 
-                    case ';': {
+                    case 'r': {
                         next();
-                        token.type = TokenType::SemiColon;
+                        decoded[length++] = '\r';
                         break;
                     }
 
-                    case ':': {
+                    case 'v': {
                         next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == ':') {
-                            next();
-                            token.type = TokenType::ColonColon;
-                            break;
-                        }
-                        token.type = TokenType::Colon;
+                        decoded[length++] = '\v';
                         break;
                     }
 
-                    case '+': {
-                        next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::AddEqual;
-                            break;
-                        }
-                        token.type = TokenType::Add;
+                    case 'x': {
+                        decoded[length++] = (char)hexEscape(2, "\\x must be followed by exactly two hex digits.").second;
                         break;
                     }
 
-                    case '-': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '>') {
-                                next();
-                                token.type = TokenType::Arrow;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::SubtractEqual;
-                                break;
-                            }
-                        }
-                        token.type = TokenType::Subtract;
+                    case 'u': {
+                        auto escape = hexEscape(4, "\\u must be followed by exactly four hex digits.");
+                        encode(escape.first, escape.second);
                         break;
                     }
 
-                    case '%': {
-                        next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::ModuloEqual;
-                            break;
-                        }
-                        token.type = TokenType::Modulo;
+                    case 'U': {
+                        auto escape = hexEscape(8, "\\U must be followed by exactly eight hex digits.");
+                        encode(escape.first, escape.second);
                         break;
                     }
 
-                    case '*': {
+                    default: {
+                        decoded[length++] = source[cursor];
                         next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::MultiplyEqual;
-                            break;
-                        }
-                        token.type = TokenType::Multiply;
                         break;
                     }
+                }
+            }
 
-                    case '/': {
-                        next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::DivideEqual;
-                            break;
-                        }
-                        token.type = TokenType::Divide;
-                        break;
+            token.litrl = std::string_view(decoded, length);
+            next();
+        }
+
+        void Lexer::scanNumber(Token &token) {
+            core::SourceLocation begin = locate(cursor);
+
+            std::uint64_t value = 0;
+            bool overflow = false;
+
+            // 0x, 0o and 0b only count as prefixes when a digit of the right base follows; otherwise "0" is a literal of its own.
+            auto prefixed = [&](char prefix, bool (*isDigit)(char)) {
+                return cursor + 2 < source.size() && source[cursor] == '0' && (source[cursor + 1] | 0x20) == prefix && isDigit(source[cursor + 2]);
+            };
+
+            auto accumulate = [&](std::uint64_t base, bool (*isDigit)(char)) {
+                next();
+                next();
+
+                while (cursor < source.size() && isDigit(source[cursor])) {
+                    std::uint64_t digit = hexDigitValue(source[cursor]);
+
+                    if (value > (UINT64_MAX - digit) / base) {
+                        overflow = true;
                     }
 
-                    case '&': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::BitAndEqual;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '&') {
-                                next();
-                                token.type = TokenType::LogicalAnd;
-                                break;
-                            }
-                        }
-                        token.type = TokenType::BitAnd;
-                        break;
+                    value = value * base + digit;
+                    next();
+                }
+            };
+
+            if (prefixed('x', isHexDigit)) {
+                accumulate(16, isHexDigit);
+            } else if (prefixed('o', isOctalDigit)) {
+                accumulate(8, isOctalDigit);
+            } else if (prefixed('b', isBinaryDigit)) {
+                accumulate(2, isBinaryDigit);
+            } else {
+                std::size_t digits = cursor;
+
+                while (digits < source.size() && isDecimalDigit(source[digits])) {
+                    ++digits;
+                }
+
+                if (digits + 1 < source.size() && source[digits] == '.' && isDecimalDigit(source[digits + 1])) {
+                    std::size_t end = digits + 1;
+
+                    while (end < source.size() && isDecimalDigit(source[end])) {
+                        ++end;
                     }
 
-                    case '^': {
-                        next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::BitXorEqual;
+                    // from_chars rounds correctly, which summing up fractional digits didn't.
+                    double decimal = 0;
+                    std::from_chars(&source[cursor], &source[end], decimal);
+
+                    cursor = (std::uint32_t)end;
+
+                    token.litrl = decimal;
+                    token.type = TokenType::Decimal;
+                    return;
+                }
+
+                const char *digit = &source[cursor];
+                const char *last = &source[digits];
+
+                // Eight digits at a time while we can; 10^8 * value + chunk overflows exactly when value > (2^64 - 1 - chunk) / 10^8.
+                if (isLittleEndian()) {
+                    while (last - digit >= 8) {
+                        std::uint64_t chunk;
+                        std::memcpy(&chunk, digit, sizeof(chunk));
+
+                        if (!isEightDigits(chunk)) {
                             break;
                         }
-                        token.type = TokenType::BitXor;
-                        break;
-                    }
 
-                    case '|': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::BitOrEqual;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '|') {
-                                next();
-                                token.type = TokenType::LogicalOr;
-                                break;
-                            }
-                        }
-                        token.type = TokenType::BitOr;
-                        break;
-                    }
+                        chunk = parseEightDigits(chunk);
 
-                    case '<': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '<') {
-                                next();
-                                if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                                    next();
-                                    token.type = TokenType::BitShiftLeftEqual;
-                                    break;
-                                }
-                                token.type = TokenType::BitShiftLeft;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::LogicalLessThanEqual;
-                                break;
-                            }
+                        if (value > (UINT64_MAX - chunk) / 100000000) {
+                            overflow = true;
                         }
-                        token.type = TokenType::LogicalLessThan;
-                        break;
-                    }
 
-                    case '>': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '>') {
-                                next();
-                                if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                                    next();
-                                    token.type = TokenType::BitShiftRightEqual;
-                                    break;
-                                }
-                                token.type = TokenType::BitShiftRight;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::LogicalGreaterThanEqual;
-                                break;
-                            }
-                        }
-                        token.type = TokenType::LogicalGreaterThan;
-                        break;
+                        value = value * 100000000 + chunk;
+                        digit += 8;
                     }
+                }
 
-                    case '~': {
-                        next();
-                        token.type = TokenType::BitNot;
-                        break;
-                    }
+                for (; digit < last; digit++) {
+                    std::uint64_t d = *digit - '0';
 
-                    case '=': {
-                        next();
-                        if (sourceLocation.pointer < source.size()) {
-                            if (source[sourceLocation.pointer] == '>') {
-                                next();
-                                token.type = TokenType::BigArrow;
-                                break;
-                            } else if (source[sourceLocation.pointer] == '=') {
-                                next();
-                                token.type = TokenType::LogicalEqual;
-                                break;
-                            }
-                        }
-                        token.type = TokenType::Equal;
-                        break;
+                    if (value > (UINT64_MAX - d) / 10) {
+                        overflow = true;
                     }
 
-                    case '!': {
-                        next();
-                        if (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] == '=') {
-                            next();
-                            token.type = TokenType::LogicalNotEqual;
-                            break;
-                        }
-                        token.type = TokenType::LogicalNot;
-                        break;
-                    }
+                    value = value * 10 + d;
+                }
 
-                    case '\'':
-                    case '"': {
-                        char delim = source[sourceLocation.pointer];
+                cursor = (std::uint32_t)digits;
+            }
 
-                        core::SourceLocation location = sourceLocation;
+            if (overflow) {
+                throw core::Error(core::Error::Type::Lexical, begin, locate(cursor), "integer literal is too large.");
+            }
 
-                        next();
-                        std::size_t length = 0;
-                        while (sourceLocation.pointer < source.size() && source[sourceLocation.pointer] != delim) {
-                            if (source[sourceLocation.pointer] == '\\') {
-                                next();
+            token.litrl = value;
+            token.type = TokenType::Integer;
+        }
 
-                                switch (source[sourceLocation.pointer]) {
-                                    case 'f': {
-                                        next();
-                                        textBuffer[length++] = '\f';
-                                        break;
-                                    }
-
-                                    case 'n': {
-                                        next();
-                                        textBuffer[length++] = '\n';
-                                        break;
-                                    }
-
-                                    case 'r': {
-                                        next();
-                                        textBuffer[length++] = '\r';
-                                        break;
-                                    }
-
-                                    case 'v': {
-                                        next();
-                                        textBuffer[length++] = '\v';
-                                        break;
-                                    }
-
-                                    case 'x': {
-                                        core::SourceLocation begin = sourceLocation;
-                                        next();
-                                        if (sourceLocation.pointer + 1 >= source.size()) {
-                                            throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, "\\x must be followed by exactly two hex digits.");
-                                        }
-
-                                        std::uint8_t hex = 0;
-                                        for (std::size_t i = 0; i < 2; i++) {
-                                            hex *= 16;
-
-                                            if (std::tolower(source[sourceLocation.pointer]) >= 'a' && std::tolower(source[sourceLocation.pointer]) <= 'f') {
-                                                hex += 10 + (source[sourceLocation.pointer] - 'a');
-                                            } else if (source[sourceLocation.pointer] >= '0' && source[sourceLocation.pointer] <= '9') {
-                                                hex += source[sourceLocation.pointer] - '0';
-                                            } else {
-                                                throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, fmt::format("invalid hex digit '{}'.", source[sourceLocation.pointer]));
-                                            }
-
-                                            next();
-                                        }
-
-                                        textBuffer[length++] = *(char*)&hex;
-                                        break;
-                                    }
-
-                                    case 'u': {
-                                        core::SourceLocation begin = sourceLocation;
-                                        next();
-                                        if (sourceLocation.pointer + 1 >= source.size()) {
-                                            throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, "\\u must be followed by exactly four hex digits.");
-                                        }
-
-                                        std::uint16_t hex = 0;
-                                        for (std::size_t i = 0; i < 4; i++) {
-                                            hex *= 16;
-
-                                            if (std::tolower(source[sourceLocation.pointer]) >= 'a' && std::tolower(source[sourceLocation.pointer]) <= 'f') {
-                                                hex += 10 + (source[sourceLocation.pointer] - 'a');
-                                            } else if (source[sourceLocation.pointer] >= '0' && source[sourceLocation.pointer] <= '9') {
-                                                hex += source[sourceLocation.pointer] - '0';
-                                            } else {
-                                                throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, fmt::format("invalid hex digit '{}'.", source[sourceLocation.pointer]));
-                                            }
-
-                                            next();
-                                        }
-
-                                        *(std::uint16_t *)textBuffer = hex;
-                                        length += 2;
-                                        break;
-                                    }
-
-                                    case 'U': {
-                                        core::SourceLocation begin = sourceLocation;
-                                        next();
-                                        if (sourceLocation.pointer + 1 >= source.size()) {
-                                            throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, "\\U must be followed by exactly eight hex digits.");
-                                        }
-
-                                        std::uint32_t hex = 0;
-                                        for (std::size_t i = 0; i < 8; i++) {
-                                            hex *= 16;
-
-                                            if (std::tolower(source[sourceLocation.pointer]) >= 'a' && std::tolower(source[sourceLocation.pointer]) <= 'f') {
-                                                hex += 10 + (source[sourceLocation.pointer] - 'a');
-                                            } else if (source[sourceLocation.pointer] >= '0' && source[sourceLocation.pointer] <= '9') {
-                                                hex += source[sourceLocation.pointer] - '0';
-                                            } else {
-                                                throw core::Error(core::Error::Type::Lexical, source, begin, sourceLocation, fmt::format("invalid hex digit '{}'.", source[sourceLocation.pointer]));
-                                            }
-
-                                            next();
-                                        }
-
-                                        *(std::uint32_t *)textBuffer = hex;
-                                        length += 4;
-                                        break;
-                                    }
-
-                                    default: {
-                                        char c = source[sourceLocation.pointer];
-                                        next();
-                                        textBuffer[length++] = c;
-                                        break;
-                                    }
-                                }
-                            } else {
-                                textBuffer[length++] = source[sourceLocation.pointer];
-                                next();
-                            }
-                        }
+        void Lexer::once() {
+            Token token;
 
-                        if (sourceLocation.pointer >= source.size() || source[sourceLocation.pointer] != delim) {
-                            throw core::Error(core::Error::Type::Lexical, source, location, sourceLocation, "unterminated literal.");
-                        }
+            if (!stream) {
+                scan(token);
+                push(std::move(token));
+                return;
+            }
 
-                        next();
-                        token.litrl = std::string(textBuffer, length);
-                        if (delim == '"') {
-                            token.type = TokenType::String;
-                        } else if (delim == '\'') {
-                            token.type = TokenType::Character;
-                        }
+            // Past the end we keep handing out the Eoi token, just like scan() does.
+            std::size_t index = std::min(streamCursor++, stream->kinds.size() - 1);
+
+            token.type = stream->kinds[index];
+            token.begin = locate(stream->begins[index]);
+            token.end = locate(stream->ends[index]);
 
+            if (token.type == TokenType::Eoi) {
+                token.text = "$EOF";
+            } else {
+                token.text = source.substr(stream->begins[index], stream->ends[index] - stream->begins[index]);
+            }
+
+            switch (token.type) {
+                case TokenType::Integer:
+                case TokenType::Decimal:
+                case TokenType::String:
+                case TokenType::Character: {
+                    token.litrl = stream->literals[literalCursor++];
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+            }
+
+            push(std::move(token));
+        }
+
+        void Lexer::lexAll() {
+            auto stream = std::make_unique<TokenStream>();
+
+            // Most tokens are a few bytes long; this saves a handful of reallocations on big files.
+            stream->kinds.reserve(source.size() / 4);
+            stream->begins.reserve(source.size() / 4);
+            stream->ends.reserve(source.size() / 4);
+
+            Token token;
+
+            do {
+                scan(token);
+
+                stream->kinds.push_back(token.type);
+                stream->begins.push_back(token.begin.position - base);
+                stream->ends.push_back(token.end.position - base);
+
+                switch (token.type) {
+                    case TokenType::Integer:
+                    case TokenType::Decimal:
+                    case TokenType::String:
+                    case TokenType::Character: {
+                        stream->literals.push_back(std::move(token.litrl));
                         break;
                     }
 
-                    default:
-                    if (std::isalpha(source[sourceLocation.pointer]) || source[sourceLocation.pointer] == '_') {
-                        std::size_t begin = sourceLocation.pointer;
+                    default: {
+                        break;
+                    }
+                }
+            } while (token.type != TokenType::Eoi);
 
-                        while (sourceLocation.pointer < source.size() && (std::isalnum(source[sourceLocation.pointer]) || source[sourceLocation.pointer] == '_')) {
-                            next();
-                        }
+            this->stream = std::move(stream);
+            streamCursor = 0;
+            literalCursor = 0;
 
-                        std::size_t length = sourceLocation.pointer - begin;
+            tokens.clear();
+            head = 0;
+            buffered = 0;
+        }
 
-                        auto is = [&](const char *s) {
-                            return std::memcmp(&source[begin], s, length * sizeof(char)) == 0;
-                        };
+        const std::unique_ptr<TokenStream> &Lexer::getStream() const {
+            return stream;
+        }
 
-                        switch (length) {
-                            case 2: {
-                                if (is("i8")) token.type = TokenType::KwI8;
-                                else if (is("u8")) token.type = TokenType::KwU8;
-                                else if (is("as")) token.type = TokenType::KwAs;
-                                else if (is("if")) token.type = TokenType::KwIf;
-                                else goto name;
+        void Lexer::push(Token &&token) {
+            if (buffered == tokens.size()) {
+                // Grow and unwrap the ring so that the oldest token is at index 0 again.
+                std::vector<Token> grown(tokens.empty() ? 16 : tokens.size() * 2);
 
-                                break;
-                            }
+                for (std::size_t i = 0; i < buffered; i++) {
+                    grown[i] = std::move(tokens[(head + i) & (tokens.size() - 1)]);
+                }
 
-                            case 3: {
-                                if (is("val")) token.type = TokenType::KwVal;
-                                else if (is("var")) token.type = TokenType::KwVar;
-                                else if (is("pub")) token.type = TokenType::KwPub;
-                                else if (is("fun")) token.type = TokenType::KwFun;
-                                else if (is("any")) token.type = TokenType::KwAny;
-                                else if (is("i16")) token.type = TokenType::KwI16;
-                                else if (is("i32")) token.type = TokenType::KwI32;
-                                else if (is("i64")) token.type = TokenType::KwI64;
-                                else if (is("u16")) token.type = TokenType::KwU16;
-                                else if (is("u32")) token.type = TokenType::KwU32;
-                                else if (is("u64")) token.type = TokenType::KwU64;
-                                else if (is("f32")) token.type = TokenType::KwF32;
-                                else if (is("f64")) token.type = TokenType::KwF64;
-                                else if (is("for")) token.type = TokenType::KwFor;
-                                else goto name;
-
-                                break;
-                            }
+                tokens = std::move(grown);
+                head = 0;
+            }
 
-                            case 4: {
-                                if (is("none")) token.type = TokenType::KwNone;
-                                else if (is("bool")) token.type = TokenType::KwBool;
-                                else if (is("true")) token.type = TokenType::KwTrue;
-                                else if (is("elif")) token.type = TokenType::KwElif;
-                                else if (is("else")) token.type = TokenType::KwElse;
-                                else if (is("enum")) token.type = TokenType::KwEnum;
-                                else goto name;
+            tokens[(head + buffered) & (tokens.size() - 1)] = std::move(token);
+            ++buffered;
+        }
 
-                                break;
-                            }
+        void Lexer::initFromBuffer(const std::shared_ptr<core::SourceBuffer> &buffer) {
+            this->buffer = buffer;
+            source = buffer->getSource();
 
-                            case 5: {
-                                if (is("false")) token.type = TokenType::KwFalse;
-                                else if (is("usize")) token.type = TokenType::KwU64; // Maybe I should make these platform-specific? idek.
-                                else if (is("isize")) token.type = TokenType::KwI64; // Maybe I should make these platform-specific? idek.
-                                else if (is("while")) token.type = TokenType::KwWhile;
-                                else if (is("break")) token.type = TokenType::KwBreak;
-                                else if (is("union")) token.type = TokenType::KwUnion;
-                                else goto name;
+            tokens.clear();
+            head = 0;
+            buffered = 0;
 
-                                break;
-                            }
+            stream.reset();
+            streamCursor = 0;
+            literalCursor = 0;
 
-                            case 6: {
-                                if (is("import")) token.type = TokenType::KwImport;
-                                else if (is("switch")) token.type = TokenType::KwSwitch;
-                                else if (is("struct")) token.type = TokenType::KwStruct;
-                                else if (is("return")) token.type = TokenType::KwReturn;
-                                else goto name;
+            stats = LookaheadStats();
 
-                                break;
-                            }
+            strings = std::make_unique<core::Arena>();
 
-                            case 7: {
-                                if (is("size_of")) token.type = TokenType::KwSizeOf;
-                                else goto name;
+            base = buffer->getBase();
+            cursor = 0;
+        }
 
-                                break;
-                            }
+        void Lexer::initFromRange(const std::shared_ptr<core::SourceBuffer> &buffer, std::uint32_t begin, std::uint32_t end) {
+            initFromBuffer(buffer);
 
-                            case 8: {
-                                if (is("continue")) token.type = TokenType::KwContinue;
-                                else goto name;
+            source = source.substr(0, end);
+            cursor = begin;
+        }
 
-                                break;
-                            }
+        void Lexer::initFromSource(const std::string &moduleName, const std::string &source) {
+            initFromBuffer(core::SourceBuffer::fromSource(moduleName, source));
+        }
 
-                            case 9: {
-                                if (is("namespace")) token.type = TokenType::KwNamespace;
-                                else goto name;
+        void Lexer::initFromFile(const std::string &filepath) {
+            initFromBuffer(core::SourceBuffer::fromFile(filepath));
+        }
 
-                                break;
-                            }
+        const std::shared_ptr<core::SourceBuffer> &Lexer::getBuffer() const {
+            return buffer;
+        }
 
-                            default: {
-                                goto name;
-                            }
-                        }
+        const LookaheadStats &Lexer::getStats() const {
+            return stats;
+        }
 
-                        break;
+        const Token &Lexer::peek(std::size_t count) {
+            ++stats.peeks;
+            stats.furthest = std::max(stats.furthest, count);
 
-                        name:
-                        token.type = TokenType::Name;
-                        break;
-                    } else if (std::isdigit(source[sourceLocation.pointer])) {
-                        token.litrl = (std::uint64_t)0;
+            while (count >= buffered) {
+                once();
+            }
 
-                        if (sourceLocation.pointer + 2 < source.size() && source[sourceLocation.pointer] == '0' && std::tolower(source[sourceLocation.pointer + 1]) == 'x' && std::isxdigit(source[sourceLocation.pointer + 2])) {
-                            next();
-                            next();
+            return tokens[(head + count) & (tokens.size() - 1)];
+        }
 
-                            while (sourceLocation.pointer < source.size() && std::isxdigit(source[sourceLocation.pointer])) {
-                                token.litrl = std::get<std::uint64_t>(token.litrl) * (std::uint64_t)16;
+        TokenType Lexer::peekType(std::size_t count) {
+            if (stream) {
+                ++stats.peeks;
+                stats.furthest = std::max(stats.furthest, count);
 
-                                if (std::isalpha(source[sourceLocation.pointer])) {
-                                    token.litrl = std::get<std::uint64_t>(token.litrl) + (std::uint64_t)10 + (std::tolower(source[sourceLocation.pointer]) - 'a');
-                                } else if (std::isdigit(source[sourceLocation.pointer])) {
-                                    token.litrl = std::get<std::uint64_t>(token.litrl) + source[sourceLocation.pointer] - '0';
-                                }
+                // streamCursor is already `buffered` tokens ahead of the parser.
+                return stream->kinds[std::min(streamCursor - buffered + count, stream->kinds.size() - 1)];
+            }
 
-                                next();
-                            }
+            return peek(count).type;
+        }
 
-                            token.type = TokenType::Integer;
-                        } else if (sourceLocation.pointer + 2 < source.size() && source[sourceLocation.pointer] == '0' && std::tolower(source[sourceLocation.pointer + 1]) == 'o' && (source[sourceLocation.pointer + 2] >= '0' && source[sourceLocation.pointer + 2] <= '7')) {
-                            next();
-                            next();
+        void Lexer::eat(std::size_t count) {
+            while (count > buffered) {
+                once();
+            }
 
-                            while (sourceLocation.pointer < source.size() && (source[sourceLocation.pointer] >= '0' && source[sourceLocation.pointer] <= '7')) {
-                                token.litrl = std::get<std::uint64_t>(token.litrl) * 8;
-                                token.litrl = std::get<std::uint64_t>(token.litrl) + source[sourceLocation.pointer] - '0';
+            head = (head + count) & (tokens.size() - 1);
+            buffered -= count;
 
-                                next();
-                            }
+            stats.eaten += count;
+        }
 
-                            token.type = TokenType::Integer;
-                        } else if (sourceLocation.pointer + 2 < source.size() && source[sourceLocation.pointer] == '0' && std::tolower(source[sourceLocation.pointer + 1] == 'b') && (source[sourceLocation.pointer + 2] == '0' || source[sourceLocation.pointer + 2] == '1')) {
-                            next();
-                            next();
+        core::SourceLocation Lexer::skipBraces() {
+            const Token &open = peek();
+            core::SourceLocation begin = open.begin, end = open.end;
 
-                            while (sourceLocation.pointer < source.size() && (source[sourceLocation.pointer] == '0' || source[sourceLocation.pointer] == '1')) {
-                                token.litrl = std::get<std::uint64_t>(token.litrl) * 2;
-                                token.litrl = std::get<std::uint64_t>(token.litrl) + source[sourceLocation.pointer] - '0';
+            std::size_t depth = 0;
 
-                                next();
-                            }
+            if (stream) {
+                // Everything was lexed already, so just count braces; the literals we pass over still have to be stepped past.
+                std::size_t index = streamCursor - buffered;
 
-                            token.type = TokenType::Integer;
-                        } else {
-                            while (sourceLocation.pointer < source.size() && std::isdigit(source[sourceLocation.pointer])) {
-                                token.litrl = std::get<std::uint64_t>(token.litrl) * 10;
-                                token.litrl = std::get<std::uint64_t>(token.litrl) + source[sourceLocation.pointer] - '0';
-                                next();
-                            }
+                for (std::size_t i = 0; i < buffered; i++) {
+                    if (isLiteral(tokens[(head + i) & (tokens.size() - 1)].type)) {
+                        --literalCursor;
+                    }
+                }
 
-                            if (sourceLocation.pointer + 1 < source.size() && source[sourceLocation.pointer] == '.' && std::isdigit(source[sourceLocation.pointer + 1])) {
-                                next();
-                                double fractional = 0, weight = 1;
+                for (;; index++) {
+                    TokenType type = stream->kinds[index];
+
+                    if (type == TokenType::LeftBrace) {
+                        ++depth;
+                    } else if (type == TokenType::RightBrace) {
+                        if (!--depth) break;
+                    } else if (type == TokenType::Eoi) {
+                        throw core::Error(core::Error::Type::Syntactic, begin, end, "expected '}' to match this '{'.");
+                    } else if (isLiteral(type)) {
+                        ++literalCursor;
+                    }
+                }
 
-                                while (sourceLocation.pointer < source.size() && std::isdigit(source[sourceLocation.pointer])) {
-                                    weight /= 10;
-                                    fractional += (source[sourceLocation.pointer] - '0') * weight;
-                                    next();
-                                }
+                streamCursor = index + 1;
+                end = locate(stream->ends[index]);
+            } else {
+                // Whatever we peeked at past the '{' is thrown away; we start again right after it.
+                cursor = begin.position - base;
 
-                                token.litrl = (double)std::get<std::uint64_t>(token.litrl) + fractional;
-                                token.type = TokenType::Decimal;
-                            } else {
-                                token.type = TokenType::Integer;
-                            }
+                do {
+                    while (cursor < source.size() && !skimTable.stops[(unsigned char)source[cursor]]) {
+                        next();
+                    }
+
+                    if (cursor >= source.size()) {
+                        throw core::Error(core::Error::Type::Syntactic, begin, end, "expected '}' to match this '{'.");
+                    }
 
+                    switch (source[cursor]) {
+                        case '{': {
+                            ++depth;
+                            next();
                             break;
                         }
-                    } else {
-                        throw core::Error(core::Error::Type::Lexical, source, sourceLocation, sourceLocation, "invalid token");
-                        break;
-                    }
-                }
-            }
 
-            token.end = sourceLocation;
+                        case '}': {
+                            --depth;
+                            next();
+                            break;
+                        }
 
-            if (!token.text.data()) {
-                token.text = std::string_view(&source[start], token.text.size());
-            }
+                        case '"':
+                        case '\'': {
+                            // Same rule as scanString(): a backslash takes the byte after it along.
+                            core::SourceLocation location = locate(cursor);
+                            char delim = source[cursor];
 
-            if (!token.text.size()) {
-                token.text = std::string_view(token.text.data(), sourceLocation.pointer - start);
-            }
+                            next();
 
-            tokens.push_back(token);
-        }
+                            for (;;) {
+                                cursor = (std::uint32_t)core::findEither(source, cursor, delim, '\\');
 
-        void Lexer::initFromSource(const std::string &moduleName, const std::string &source) {
-            this->source = source;
+                                if (cursor >= source.size()) {
+                                    throw core::Error(core::Error::Type::Lexical, location, locate((std::uint32_t)source.size()), "unterminated literal.");
+                                }
 
-            sourceLocation.source = this->source;
-            sourceLocation.moduleName = moduleName;
-            sourceLocation.line = 1;
-            sourceLocation.lexpos = 1;
-        }
+                                if (source[cursor] == delim) {
+                                    break;
+                                }
 
-        void Lexer::initFromFile(const std::string &filepath) {
-            std::FILE *file = std::fopen(filepath.c_str(), "rt");
-            std::fseek(file, 0, SEEK_END);
-            std::size_t size = std::ftell(file);
-            std::rewind(file);
+                                cursor += 2;
+                            }
 
-            char *buffer = new char[size + 1];
-            std::memset(buffer, 0, (size + 1) * sizeof(char));
-            std::fread(buffer, 1, size, file);
+                            next();
+                            break;
+                        }
 
-            initFromSource(filepath, buffer);
+                        default: {
+                            // '#' or '/'; skip() knows what to do with comments and leaves anything else alone.
+                            std::uint32_t before = cursor;
+                            skip();
 
-            delete[] buffer;
-        }
+                            if (cursor == before) {
+                                next();
+                            }
 
-        const Token &Lexer::peek(std::size_t count) {
-            while (count >= tokens.size()) {
-                once();
+                            break;
+                        }
+                    }
+                } while (depth);
+
+                end = locate(cursor);
             }
 
-            return tokens[count];
-        }
+            head = 0;
+            buffered = 0;
 
-        void Lexer::eat(std::size_t count) {
-            tokens.erase(tokens.begin(), tokens.begin() + count);
+            ++stats.eaten;
+            return end;
         }
     }
 }
@@ -0,0 +1,18 @@
+#include "rtl/Parser/Module.h"
+
+namespace rtl {
+    namespace parser {
+        void Module::merge(Module &&other) {
+            arena.absorb(std::move(other.arena));
+            nodeCount += other.nodeCount;
+            other.nodeCount = 0;
+
+            nodes.insert(nodes.end(), other.nodes.begin(), other.nodes.end());
+            other.nodes.clear();
+        }
+
+        std::size_t Module::getNodeCount() const {
+            return nodeCount;
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#include "rtl/Parser/ModuleLoader.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+namespace rtl {
+    namespace parser {
+        ModuleLoader::ModuleLoader(core::ThreadPool &pool, bool lexAll, bool skim) : pool(pool) {
+            this->lexAll = lexAll;
+            this->skim = skim;
+        }
+
+        Module *ModuleLoader::request(const std::string &path) {
+            std::string canonical = std::filesystem::weakly_canonical(path).string();
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            auto it = entries.find(canonical);
+            if (it != entries.end()) {
+                return it->second->module.get();
+            }
+
+            auto entry = std::make_unique<Entry>();
+            entry->module = std::make_unique<Module>();
+            entry->module->path = path;
+            entry->parser = std::make_unique<Parser>(*entry->module);
+
+            Entry *scheduled = entry.get();
+            byModule.emplace(scheduled->module.get(), scheduled);
+            entries.emplace(std::move(canonical), std::move(entry));
+
+            ++pending;
+            lock.unlock();
+
+            pool.submit([this, scheduled]() { parse(scheduled); });
+            return scheduled->module.get();
+        }
+
+        void ModuleLoader::parse(Entry *entry) {
+            try {
+                std::filesystem::path directory = std::filesystem::path(entry->module->path).parent_path();
+
+                entry->parser->setImportHandler([this, &directory](const Module::Import &import) {
+                    std::filesystem::path path = (directory / import.path).lexically_normal();
+
+                    if (!std::filesystem::is_regular_file(path)) {
+                        throw core::Error(core::Error::Type::Syntactic, import.begin, import.end, fmt::format("no such file to import: '{}'.", path.string()));
+                    }
+
+                    return request(path.string());
+                });
+
+                entry->parser->setSkim(skim);
+                entry->parser->initFromFile(entry->module->path);
+
+                if (lexAll) {
+                    entry->parser->getLexer()->lexAll();
+                }
+
+                entry->parser->parseSyntaxTree();
+            } catch (...) {
+                entry->error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!--pending) {
+                idle.notify_all();
+            }
+        }
+
+        Module *ModuleLoader::load(const std::string &filepath) {
+            Module *module = request(filepath);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            roots.push_back(module);
+
+            return module;
+        }
+
+        std::vector<Module *> ModuleLoader::wait(std::vector<core::Error> &errors) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                idle.wait(lock, [this]() { return !pending; });
+            }
+
+            enum class Mark { None, Visiting, Done };
+            std::unordered_map<const Module *, Mark> marks;
+
+            std::vector<Module *> order;
+            std::vector<Module *> path; // The imports we're inside of, for describing a cycle.
+
+            std::function<void(Module *)> visit = [&](Module *module) {
+                marks[module] = Mark::Visiting;
+                path.push_back(module);
+
+                for (const auto &import : module->imports) {
+                    if (!import.module) {
+                        continue;
+                    }
+
+                    Mark mark = marks[import.module];
+                    if (mark == Mark::Visiting) {
+                        std::string cycle;
+                        for (auto it = std::find(path.begin(), path.end(), import.module); it != path.end(); ++it) {
+                            cycle += fmt::format("{} -> ", (*it)->path);
+                        }
+
+                        cycle += import.module->path;
+                        errors.emplace_back(core::Error::Type::Syntactic, import.begin, import.end, fmt::format("import cycle: {}.", cycle));
+                    } else if (mark == Mark::None) {
+                        visit(import.module);
+                    }
+                }
+
+                path.pop_back();
+                marks[module] = Mark::Done;
+
+                if (Entry *entry = byModule.at(module); entry->error) {
+                    try {
+                        std::rethrow_exception(entry->error);
+                    } catch (const core::Error &e) {
+                        errors.push_back(e);
+                    }
+                }
+
+                order.push_back(module);
+            };
+
+            for (auto root : roots) {
+                if (marks[root] == Mark::None) {
+                    visit(root);
+                }
+            }
+
+            return order;
+        }
+
+        const Parser &ModuleLoader::getParser(const Module &module) const {
+            return *byModule.at(&module)->parser;
+        }
+    }
+}
@@ -4,12 +4,17 @@
 
 #include <fmt/format.h>
 
+#include <deque>
+#include <exception>
+#include <future>
+
 using namespace rtl::parser;
 
 namespace rtl {
     namespace sema {
-        Driver::Driver(std::vector<std::shared_ptr<ASTNode>> &nodes, std::vector<core::Error> &errors) : nodes(nodes), errors(errors) {
+        Driver::Driver(Module &module, std::vector<core::Error> &errors, core::ThreadPool *pool) : module(module), errors(errors), pool(pool) {
             builtinTypes = std::make_shared<BuiltinTypes>();
+            typeContext = std::make_shared<TypeContext>();
 
             builtinTypes->noneType = std::make_shared<TypeDeclaration>(TypeDeclaration::Tag::None);
 
@@ -29,12 +34,94 @@ namespace rtl {
             builtinTypes->f64Type = std::make_shared<TypeDeclaration>(TypeDeclaration::Tag::F64);
         }
 
+        void Driver::setLazy(bool lazy) {
+            this->lazy = lazy;
+        }
+
+        void Driver::setRecordDependencies(bool record) {
+            recordDependencies = record;
+        }
+
         void Driver::run() {
-            auto validator = std::make_shared<Validator>(builtinTypes, nodes, errors);
-            validator->validate();
+            auto validator = std::make_shared<Validator>(builtinTypes, typeContext, module, errors);
+            validator->setRecordDependencies(recordDependencies);
+
+            if (lazy) {
+                validator->validateReachable(core::Interner::global().intern("main"));
+                dependencies = validator->takeDependencies();
+                return;
+            }
+
+            if (!pool || pool->getThreadCount() < 2) {
+                validator->validate();
+                dependencies = validator->takeDependencies();
+                return;
+            }
+
+            validator->collectDeclarations();
+            dependencies = validator->takeDependencies(); // The top-level variables'.
+
+            // The top level is cut into contiguous runs, a few per thread so that one run of big functions doesn't leave the other threads idle at the end.
+            // Each run reports into and allocates from its own buffers; they're merged back in source order, so the output is the same as validating serially.
+            struct Run {
+                std::size_t begin, end;
+
+                Module module;
+                std::vector<core::Error> errors;
+                std::exception_ptr exception;
+
+                Validator::Dependencies dependencies;
+            };
+
+            std::size_t count = module.nodes.size();
+            std::size_t runCount = std::min(count, pool->getThreadCount() * 4);
+
+            std::deque<Run> runs;
+            std::vector<std::future<void>> futures;
+            futures.reserve(runCount);
+
+            for (std::size_t i = 0; i < runCount; i++) {
+                auto &run = runs.emplace_back();
+                run.begin = count * i / runCount;
+                run.end = count * (i + 1) / runCount;
+
+                futures.push_back(pool->submit([&validator, &run]() {
+                    Validator runValidator(*validator, run.module, run.errors);
+
+                    try {
+                        runValidator.validate(run.begin, run.end);
+                    } catch (...) {
+                        run.exception = std::current_exception();
+                    }
+
+                    run.dependencies = runValidator.takeDependencies();
+                }));
+            }
+
+            for (auto &future : futures) {
+                future.get();
+            }
+
+            // Every run's nodes are kept, even past an error, since the tree points into all of them.
+            for (auto &run : runs) {
+                module.merge(std::move(run.module));
+                dependencies.merge(run.dependencies);
+            }
+
+            for (auto &run : runs) {
+                errors.insert(errors.end(), run.errors.begin(), run.errors.end());
+
+                if (run.exception) {
+                    std::rethrow_exception(run.exception);
+                }
+            }
 
             // auto typeChecker = std::make_shared<TypeChecker>(builtinTypes, nodes, errors);
             // typeChecker->run();
         }
+
+        const Validator::Dependencies &Driver::getDependencies() const {
+            return dependencies;
+        }
     }
 }
\ No newline at end of file
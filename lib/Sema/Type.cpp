@@ -10,13 +10,15 @@ namespace rtl {
             return tag;
         }
 
-        Type::Type(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer) {
-            this->decl = decl;
-            this->pointer = pointer;
+        Type::Type(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer, std::uint32_t id) : pointer(pointer), id(id), decl(decl) {
         }
 
         std::uint32_t Type::getPointer() const {
             return pointer;
         }
+
+        std::uint32_t Type::getId() const {
+            return id;
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "rtl/Sema/TypeContext.h"
+
+#include <mutex>
+
+namespace rtl {
+    namespace sema {
+        std::size_t TypeContext::KeyHash::operator()(const std::pair<const TypeDeclaration *, std::uint32_t> &key) const {
+            std::size_t hash = std::hash<const TypeDeclaration *>()(key.first);
+            return hash ^ (key.second + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+        }
+
+        std::size_t TypeContext::KeyHash::operator()(const std::vector<std::uint32_t> &key) const {
+            std::size_t hash = key.size();
+
+            for (auto id : key) {
+                hash ^= id + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+
+            return hash;
+        }
+
+        TypeContext::TypeContext() {
+            byId.emplace_back(); // ID 0.
+        }
+
+        std::shared_ptr<Type> TypeContext::get(const std::shared_ptr<TypeDeclaration> &decl, std::uint32_t pointer) {
+            auto key = std::make_pair((const TypeDeclaration *)decl.get(), pointer);
+
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+
+                auto it = types.find(key);
+                if (it != types.end()) {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+
+            // Somebody may have beaten us to it between the two locks.
+            auto it = types.find(key);
+            if (it != types.end()) {
+                return it->second;
+            }
+
+            auto type = std::make_shared<Type>(decl, pointer, (std::uint32_t)byId.size());
+
+            byId.push_back(type);
+            types.emplace(key, type);
+
+            return type;
+        }
+
+        std::shared_ptr<TypeDeclaration> TypeContext::getPrototypeDeclaration(const std::shared_ptr<Type> &rt, const std::vector<std::shared_ptr<Type>> &paramTypes) {
+            std::vector<std::uint32_t> key;
+            key.reserve(paramTypes.size() + 1);
+
+            key.push_back(rt ? rt->getId() : 0);
+            for (auto &paramType : paramTypes) {
+                key.push_back(paramType ? paramType->getId() : 0);
+            }
+
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+
+                auto it = prototypes.find(key);
+                if (it != prototypes.end()) {
+                    return it->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+
+            auto it = prototypes.find(key);
+            if (it != prototypes.end()) {
+                return it->second;
+            }
+
+            auto decl = std::make_shared<TypeDeclaration>(TypeDeclaration::Tag::FunctionPrototype);
+            std::get<FunctionPrototype>(decl->info).rt = rt;
+            std::get<FunctionPrototype>(decl->info).paramTypes = paramTypes;
+
+            prototypes.emplace(std::move(key), decl);
+
+            return decl;
+        }
+
+        std::shared_ptr<Type> TypeContext::getPrototype(const std::shared_ptr<Type> &rt, const std::vector<std::shared_ptr<Type>> &paramTypes) {
+            return get(getPrototypeDeclaration(rt, paramTypes), 0);
+        }
+
+        std::shared_ptr<Type> TypeContext::getById(std::uint32_t id) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return byId[id];
+        }
+
+        std::size_t TypeContext::size() const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return byId.size() - 1;
+        }
+    }
+}
@@ -6,15 +6,15 @@ using namespace rtl::parser; // So that we don't have to type parser::AST*
 
 namespace rtl {
     namespace sema {
-        Typer::Typer(const std::shared_ptr<BuiltinTypes> &builtinTypes, std::vector<std::shared_ptr<ASTNode>> &nodes, std::vector<core::Error> &errors) : builtinTypes(builtinTypes), nodes(nodes), errors(errors) {
+        Typer::Typer(const std::shared_ptr<BuiltinTypes> &builtinTypes, const std::shared_ptr<TypeContext> &typeContext, std::vector<ASTNode *> &nodes, std::vector<core::Error> &errors) : builtinTypes(builtinTypes), typeContext(typeContext), nodes(nodes), errors(errors) {
         }
 
-        std::shared_ptr<TypeDeclaration> Typer::getTypeDeclaration(const std::shared_ptr<ASTNode> &typeIdentifier) {
+        std::shared_ptr<TypeDeclaration> Typer::getTypeDeclaration(ASTNode *typeIdentifier) {
             if (typeIdentifier->getType() != ASTType::BuiltinType) {
-                throw std::domain_error(fmt::format("{}:{}:{}: custom types are not yet supported :(", typeIdentifier->begin.moduleName, typeIdentifier->begin.line, typeIdentifier->begin.lexpos));
+                throw std::domain_error(fmt::format("{}: custom types are not yet supported :(", typeIdentifier->begin.getFormatted()));
             }
 
-            auto builtin = std::reinterpret_pointer_cast<ASTBuiltinType>(typeIdentifier);
+            auto builtin = static_cast<ASTBuiltinType *>(typeIdentifier);
 
             using Ty = ASTBuiltinType::Type;
 
@@ -68,19 +68,17 @@ namespace rtl {
                 }
 
                 case Ty::FunctionPrototype: {
-                    auto decl = std::make_shared<TypeDeclaration>(TypeDeclaration::Tag::FunctionPrototype);
-
                     typeType(builtin->fpData.rt);
-                    std::get<FunctionPrototype>(decl->info).rt = builtin->fpData.rt.evaluatedType;
 
-                    std::get<FunctionPrototype>(decl->info).paramTypes.reserve(builtin->fpData.paramTypes.size());
+                    std::vector<std::shared_ptr<Type>> paramTypes;
+                    paramTypes.reserve(builtin->fpData.paramTypes.size());
 
                     for (auto &pty : builtin->fpData.paramTypes) {
                         typeType(pty);
-                        std::get<FunctionPrototype>(decl->info).paramTypes.push_back(pty.evaluatedType);
+                        paramTypes.push_back(pty.evaluatedType);
                     }
 
-                    return decl;
+                    return typeContext->getPrototypeDeclaration(builtin->fpData.rt.evaluatedType, paramTypes);
                 }
             }
 
@@ -89,10 +87,10 @@ namespace rtl {
 
         std::shared_ptr<Type> Typer::mapType(const parser::Type &type) {
             auto decl = getTypeDeclaration(type.baseType);
-            return std::make_shared<Type>(decl, type.pointer);
+            return typeContext->get(decl, type.pointer);
         }
 
-        void Typer::typeFunction(const std::shared_ptr<ASTFunctionHeader> &function) {
+        void Typer::typeFunction(ASTFunctionHeader *function) {
             auto lastFunction = currentFunction;
             currentFunction = function;
 
@@ -103,29 +101,28 @@ namespace rtl {
             function->rt.evaluatedType = mapType(function->rt);
 
             // Create prototype
-            function->prototype = std::make_shared<Type>(std::make_shared<TypeDeclaration>(TypeDeclaration::Tag::FunctionPrototype), 0);
-
-            std::get<FunctionPrototype>(function->prototype->decl->info).rt = function->rt.evaluatedType;
-
-            std::get<FunctionPrototype>(function->prototype->decl->info).paramTypes.reserve(function->paramDecls.size());
+            std::vector<std::shared_ptr<Type>> paramTypes;
+            paramTypes.reserve(function->paramDecls.size());
 
             for (auto &pd : function->paramDecls) {
-                std::get<FunctionPrototype>(function->prototype->decl->info).paramTypes.push_back(pd->targetTy.evaluatedType);
+                paramTypes.push_back(pd->targetTy.evaluatedType);
             }
 
+            function->prototype = typeContext->getPrototype(function->rt.evaluatedType, paramTypes);
+
             currentFunction = lastFunction;
         }
 
-        void Typer::typeVariableDeclaration(const std::shared_ptr<ASTVariableDeclaration> &decl) {
+        void Typer::typeVariableDeclaration(ASTVariableDeclaration *decl) {
             decl->targetTy.evaluatedType = mapType(decl->targetTy);
         }
 
-        void Typer::typeVariableDefinition(const std::shared_ptr<ASTVariableDefinition> &defn) {
+        void Typer::typeVariableDefinition(ASTVariableDefinition *defn) {
             typeVariableDeclaration(defn->decl);
-            typeExpression(std::reinterpret_pointer_cast<ASTExpression>(defn->expr));
+            typeExpression(static_cast<ASTExpression *>(defn->expr));
 
-            if (defn->decl->targetTy.baseType->getType() == ASTType::BuiltinType && std::reinterpret_pointer_cast<ASTBuiltinType>(defn->decl->targetTy.baseType)->builtinType == ASTBuiltinType::Type::Auto) {
-                defn->decl->targetTy.evaluatedType = std::reinterpret_pointer_cast<ASTExpression>(defn->expr)->evaluatedType;
+            if (defn->decl->targetTy.baseType->getType() == ASTType::BuiltinType && static_cast<ASTBuiltinType *>(defn->decl->targetTy.baseType)->builtinType == ASTBuiltinType::Type::Auto) {
+                defn->decl->targetTy.evaluatedType = static_cast<ASTExpression *>(defn->expr)->evaluatedType;
             }
 
             if (!defn->decl->targetTy.evaluatedType->decl) {
@@ -133,47 +130,47 @@ namespace rtl {
                     throw std::runtime_error("Invalid expression in variable definition");
                 }
 
-                defn->decl->targetTy.evaluatedType->decl = (std::reinterpret_pointer_cast<ASTExpression>(defn->expr))->evaluatedType->decl;
+                defn->decl->targetTy.evaluatedType = static_cast<ASTExpression *>(defn->expr)->evaluatedType;
             }
         }
 
-        void Typer::typeExpression(const std::shared_ptr<ASTExpression> &expr) {
+        void Typer::typeExpression(ASTExpression *expr) {
             using Ty = ASTExpression::Type;
 
             if (expr->evaluatedType) return;
 
             switch (expr->getExprType()) {
                 case Ty::Literal: {
-                    auto literal = std::reinterpret_pointer_cast<ASTLiteral>(expr);
+                    auto literal = static_cast<ASTLiteral *>(expr);
 
                     switch (literal->literalType) {
                         case ASTLiteral::Type::Integer: {
                             if (literal->getInteger() > 0xffffffff) {
-                                literal->evaluatedType = std::make_shared<Type>(builtinTypes->i64Type, 0);
+                                literal->evaluatedType = typeContext->get(builtinTypes->i64Type, 0);
                             } else {
-                                literal->evaluatedType = std::make_shared<Type>(builtinTypes->i32Type, 0);
+                                literal->evaluatedType = typeContext->get(builtinTypes->i32Type, 0);
                             }
 
                             break;
                         }
 
                         case ASTLiteral::Type::Decimal: {
-                            literal->evaluatedType = std::make_shared<Type>(builtinTypes->f32Type, 0);
+                            literal->evaluatedType = typeContext->get(builtinTypes->f32Type, 0);
                             break;
                         }
 
                         case ASTLiteral::Type::String: {
-                            literal->evaluatedType = std::make_shared<Type>(builtinTypes->u8Type, 1);
+                            literal->evaluatedType = typeContext->get(builtinTypes->u8Type, 1);
                             break;
                         }
 
                         case ASTLiteral::Type::Character: {
-                            literal->evaluatedType = std::make_shared<Type>(builtinTypes->u8Type, 0);
+                            literal->evaluatedType = typeContext->get(builtinTypes->u8Type, 0);
                             break;
                         }
 
                         case ASTLiteral::Type::Bool: {
-                            literal->evaluatedType = std::make_shared<Type>(builtinTypes->boolType, 0);
+                            literal->evaluatedType = typeContext->get(builtinTypes->boolType, 0);
                             break;
                         }
                     }
@@ -182,9 +179,9 @@ namespace rtl {
                 }
 
                 case Ty::Conversion: {
-                    auto conversion = std::reinterpret_pointer_cast<ASTConversion>(expr);
+                    auto conversion = static_cast<ASTConversion *>(expr);
 
-                    typeExpression(std::reinterpret_pointer_cast<ASTExpression>(conversion->from));
+                    typeExpression(static_cast<ASTExpression *>(conversion->from));
                     typeType(conversion->to);
                     conversion->evaluatedType = conversion->to.evaluatedType;
 
@@ -192,30 +189,30 @@ namespace rtl {
                 }
 
                 case Ty::UnaryOperator: {
-                    auto unop = std::reinterpret_pointer_cast<ASTUnaryOperator>(expr);
+                    auto unop = static_cast<ASTUnaryOperator *>(expr);
 
-                    typeExpression(std::reinterpret_pointer_cast<ASTExpression>(unop->node));
+                    typeExpression(static_cast<ASTExpression *>(unop->node));
 
-                    unop->evaluatedType = (std::reinterpret_pointer_cast<ASTExpression>(unop->node))->evaluatedType;
+                    unop->evaluatedType = (static_cast<ASTExpression *>(unop->node))->evaluatedType;
                     break;
                 }
 
                 case Ty::BinaryOperator: {
-                    auto binop = std::reinterpret_pointer_cast<ASTBinaryOperator>(expr);
+                    auto binop = static_cast<ASTBinaryOperator *>(expr);
 
-                    typeExpression(std::reinterpret_pointer_cast<ASTExpression>(binop->left));
-                    typeExpression(std::reinterpret_pointer_cast<ASTExpression>(binop->right));
+                    typeExpression(static_cast<ASTExpression *>(binop->left));
+                    typeExpression(static_cast<ASTExpression *>(binop->right));
 
-                    binop->evaluatedType = (std::reinterpret_pointer_cast<ASTExpression>(binop->right))->evaluatedType;
+                    binop->evaluatedType = (static_cast<ASTExpression *>(binop->right))->evaluatedType;
                     break;
                 }
 
                 case Ty::Call: {
-                    auto call = std::reinterpret_pointer_cast<ASTCall>(expr);
+                    auto call = static_cast<ASTCall *>(expr);
                     if (call->called->getType() == ASTType::FunctionHeader) {
-                        call->evaluatedType = (std::reinterpret_pointer_cast<ASTFunctionHeader>(call->called))->rt.evaluatedType;
+                        call->evaluatedType = (static_cast<ASTFunctionHeader *>(call->called))->rt.evaluatedType;
                     } else if (call->called->getType() == ASTType::VariableDeclaration) {
-                        call->evaluatedType = std::get<FunctionPrototype>((std::reinterpret_pointer_cast<ASTVariableDeclaration>(call->called)->targetTy.evaluatedType->decl->info)).rt;
+                        call->evaluatedType = std::get<FunctionPrototype>((static_cast<ASTVariableDeclaration *>(call->called)->targetTy.evaluatedType->decl->info)).rt;
                     } else {
                         #ifndef STRINGIFY
                         #define STRINGIFY(x) STR(x)
@@ -234,24 +231,33 @@ namespace rtl {
             type.evaluatedType = mapType(type);
         }
 
-        void Typer::typeNode(const std::shared_ptr<ASTNode> &node) {
+        void Typer::visitNode(ASTNode * /*node*/) {
+            throw std::runtime_error("Unhandled typeNode call");
+        }
+
+        void Typer::visitFunctionHeader(ASTFunctionHeader *function) {
+            typeFunction(function);
+        }
+
+        void Typer::visitVariableDeclaration(ASTVariableDeclaration *decl) {
+            typeVariableDeclaration(decl);
+        }
+
+        void Typer::visitVariableDefinition(ASTVariableDefinition *defn) {
+            typeVariableDefinition(defn);
+        }
+
+        void Typer::visitReturn(ASTReturn *returnStatement) {
+            typeExpression(static_cast<ASTExpression *>(returnStatement->expr));
+        }
+
+        void Typer::visitExpression(ASTExpression *expr) {
+            typeExpression(expr);
+        }
+
+        void Typer::typeNode(ASTNode *node) {
             // Todo(Sean): Check if nodes are typed so that we aren't constantly re-typing them.
-            auto type = node->getType();
-
-            if (node->getType() == ASTType::FunctionHeader) {
-                typeFunction(std::reinterpret_pointer_cast<ASTFunctionHeader>(node));
-            } else if (node->getType() == ASTType::Expression) {
-                typeExpression(std::reinterpret_pointer_cast<ASTExpression>(node));
-            } else if (node->getType() == ASTType::VariableDeclaration) {
-                typeVariableDeclaration(std::reinterpret_pointer_cast<ASTVariableDeclaration>(node));
-            } else if (node->getType() == ASTType::VariableDefinition) {
-                typeVariableDefinition(std::reinterpret_pointer_cast<ASTVariableDefinition>(node));
-            } else if (node->getType() == ASTType::Return) {
-                auto returnStatement = std::reinterpret_pointer_cast<ASTReturn>(node);
-                typeExpression(std::reinterpret_pointer_cast<ASTExpression>(returnStatement->expr));
-            } else {
-                throw std::runtime_error("Unhandled typeNode call");
-            }
+            visit(node);
         }
     }
-}
\ No newline at end of file
+}
@@ -2,275 +2,291 @@
 
 #include <signal.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include <fmt/format.h>
 
 using namespace rtl::parser;
 
 namespace rtl {
     namespace sema {
-        Validator::Validator(std::shared_ptr<BuiltinTypes> builtinTypes, std::vector<std::shared_ptr<ASTNode>> &nodes, std::vector<core::Error> &errors) : builtinTypes(builtinTypes), nodes(nodes), errors(errors) {
-            typer = std::make_shared<Typer>(builtinTypes, nodes, errors);
+        Validator::Validator(std::shared_ptr<BuiltinTypes> builtinTypes, std::shared_ptr<TypeContext> typeContext, Module &module, std::vector<core::Error> &errors) : builtinTypes(builtinTypes), typeContext(typeContext), module(module), nodes(module.nodes), errors(errors) {
+            typer = std::make_shared<Typer>(builtinTypes, typeContext, nodes, errors);
+            declarations = std::make_shared<Declarations>();
+        }
+
+        Validator::Validator(const Validator &collected, Module &module, std::vector<core::Error> &errors) : builtinTypes(collected.builtinTypes), typeContext(collected.typeContext), module(module), nodes(collected.nodes), errors(errors), declarations(collected.declarations), recordDependencies(collected.recordDependencies) {
+            typer = std::make_shared<Typer>(builtinTypes, typeContext, nodes, errors);
         }
 
-        std::string Validator::unqualifyName(const std::shared_ptr<ASTNode> &name) {
+        std::string Validator::unqualifyName(ASTNode *name) {
             std::string result;
 
-            if (name->getType() == ASTType::Expression) {
-                auto expr = std::reinterpret_pointer_cast<ASTExpression>(name);
-
-                if (expr->getExprType() == ASTExpression::Type::Literal) {
-                    auto literal = std::reinterpret_pointer_cast<ASTLiteral>(expr);
-                    result = literal->getString();
-                } else if (expr->getExprType() == ASTExpression::Type::BinaryOperator) {
-                    auto binop = std::reinterpret_pointer_cast<ASTBinaryOperator>(expr);
-                    const char *opname;
-                    if (binop->binopType == ASTBinaryOperator::Type::NamespaceResolution) opname = "::";
-                    else if (binop->binopType == ASTBinaryOperator::Type::MemberResolution) opname = ".";
-                    result = unqualifyName(binop->left) + opname + unqualifyName(binop->right);
-                }
+            if (name->kind == ASTKind::Literal) {
+                auto literal = static_cast<ASTLiteral *>(name);
+                result = literal->getString();
+            } else if (name->kind == ASTKind::BinaryOperator) {
+                auto binop = static_cast<ASTBinaryOperator *>(name);
+                const char *opname;
+                if (binop->binopType == ASTBinaryOperator::Type::NamespaceResolution) opname = "::";
+                else if (binop->binopType == ASTBinaryOperator::Type::MemberResolution) opname = ".";
+                result = unqualifyName(binop->left) + opname + unqualifyName(binop->right);
             }
 
             return result;
         }
 
-        bool Validator::compareQualifiedNames(const std::shared_ptr<ASTNode> &left, const std::shared_ptr<ASTNode> &right) {
-            if (left->getType() != ASTType::Expression || right->getType() != ASTType::Expression) return false;
+        std::pair<bool, ASTFunctionHeader *> Validator::isRepeatFunctionDeclaration(ASTFunctionHeader *decl) {
+            auto first = findOverload(nameKey(decl->name), std::get<FunctionPrototype>(decl->prototype->decl->info).paramTypes);
 
-            auto leftExpr = std::reinterpret_pointer_cast<ASTExpression>(left);
-            auto rightExpr = std::reinterpret_pointer_cast<ASTExpression>(right);
+            if (first && first != decl) {
+                return std::make_pair(true, first);
+            }
 
-            if (leftExpr->getExprType() != rightExpr->getExprType()) return false;
+            return std::make_pair(false, nullptr);
+        }
 
-            auto ty = std::reinterpret_pointer_cast<ASTExpression>(left)->getExprType();
+        std::pair<bool, ASTVariableDeclaration *> Validator::isRepeatDeclaration(ASTVariableDeclaration *decl) {
+            if (!currentBlock || scopes.empty()) return std::make_pair(false, nullptr);
 
-            if (ty == ASTExpression::Type::Literal) {
-                auto leftLiteral = std::reinterpret_pointer_cast<ASTLiteral>(left);
-                auto rightLiteral = std::reinterpret_pointer_cast<ASTLiteral>(rightExpr);
+            core::Symbol key = nameKey(decl->name);
+            if (!key) return std::make_pair(false, nullptr);
 
-                return leftLiteral->hash == rightLiteral->hash;
-            } else if (ty == ASTExpression::Type::BinaryOperator) {
-                auto leftBinop = std::reinterpret_pointer_cast<ASTBinaryOperator>(left);
-                auto rightBinop = std::reinterpret_pointer_cast<ASTBinaryOperator>(right);
+            auto previous = [&](const Scope &scope) -> ASTVariableDeclaration * {
+                auto it = scope.find(key);
+                if (it == scope.end()) return nullptr;
 
-                return compareQualifiedNames(leftBinop->left, rightBinop->left) && compareQualifiedNames(leftBinop->right, rightBinop->right);
+                auto found = it->second->kind == ASTKind::VariableDefinition ? static_cast<ASTVariableDefinition *>(it->second)->decl : static_cast<ASTVariableDeclaration *>(it->second);
+                return found == decl ? nullptr : found;
+            };
+
+            // The block we're in, then the parameters (which are the outermost scope while we're in a function).
+            if (auto found = previous(scopes.back())) {
+                return std::make_pair(true, found);
+            }
+
+            if (currentFunction) {
+                if (auto found = previous(scopes.front())) {
+                    return std::make_pair(true, found);
+                }
             }
 
+            return std::make_pair(false, nullptr);
+        }
+
+        bool Validator::isImplicitlyConvertible(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right) {
             return false;
         }
 
-        std::pair<bool, std::shared_ptr<ASTFunctionHeader>> Validator::isRepeatFunctionDeclaration(const std::shared_ptr<ASTFunctionHeader> &decl) {
-            if (!currentFunction) return std::make_pair(false, std::shared_ptr<ASTFunctionHeader> {});
+        bool Validator::compareTypes(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right) {
+            return left == right; // Both come from typeContext, which hands out one object per type.
+        }
 
-            for (auto &node : nodes) {
-                if (node->getType() == ASTType::FunctionHeader) {
-                    auto function = std::reinterpret_pointer_cast<ASTFunctionHeader>(node);
-                    if (decl == function) break;
-
-                    if (compareQualifiedNames(currentFunction->name, function->name)) {
-                        if (currentFunction->paramDecls.size() == function->paramDecls.size()) {
-                            bool verbatim = true;
-
-                            for (std::size_t i = 0; i < currentFunction->paramDecls.size(); i++) {
-                                auto p1 = currentFunction->paramDecls[i];
-                                auto p2 = function->paramDecls[i];
-
-                                if (!compareTypes(p1->targetTy.evaluatedType, p2->targetTy.evaluatedType)) {
-                                    verbatim = false;
-                                    break;
-                                }
-                            }
+        std::size_t Validator::hashTypes(const std::vector<std::shared_ptr<Type>> &types) {
+            std::size_t hash = types.size();
 
-                            if (verbatim) {
-                                return std::make_pair(true, function);
-                            }
-                        }
-                    }
+            for (auto &type : types) {
+                hash ^= (type ? type->getId() : 0) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+
+            return hash;
+        }
+
+        ASTFunctionHeader *Validator::findOverload(core::Symbol name, const std::vector<std::shared_ptr<Type>> &paramTypes) {
+            auto set = overloadsOf(name);
+            if (!set) return nullptr;
+
+            auto bucket = set->find(hashTypes(paramTypes));
+            if (bucket == set->end()) return nullptr;
+
+            for (auto &function : bucket->second) {
+                if (std::get<FunctionPrototype>(function->prototype->decl->info).paramTypes == paramTypes) {
+                    return function;
                 }
             }
 
-            return std::make_pair(false, std::shared_ptr<ASTFunctionHeader> {});
+            return nullptr;
         }
 
-        std::pair<bool, std::shared_ptr<ASTVariableDeclaration>> Validator::isRepeatDeclaration(const std::shared_ptr<ASTVariableDeclaration> &decl) {
-            if (!currentBlock) return std::make_pair(false, std::shared_ptr<ASTVariableDeclaration> {});
+        std::shared_ptr<Type> Validator::getArgumentType(ASTNode *arg) {
+            if (arg->getType() == ASTType::Expression) {
+                return static_cast<ASTExpression *>(arg)->evaluatedType;
+            } else if (arg->getType() == ASTType::VariableDeclaration) {
+                return static_cast<ASTVariableDeclaration *>(arg)->targetTy.evaluatedType;
+            } else if (arg->getType() == ASTType::VariableDefinition) {
+                return static_cast<ASTVariableDefinition *>(arg)->decl->targetTy.evaluatedType;
+            }
 
-            auto block = currentBlock;
+            errors.emplace_back(core::Error::Type::Semantic, arg->begin, arg->end, "unsupported call param.");
+            return typeContext->get(builtinTypes->noneType, 0);
+        }
 
-            for (auto &node : block->nodes) {
-                if (node->getType() == ASTType::VariableDeclaration) {
-                    auto decl2 = std::reinterpret_pointer_cast<ASTVariableDeclaration>(node);
-                    if (decl == decl2) break;
+        core::Symbol Validator::nameKey(ASTNode *name) {
+            if (name->kind == ASTKind::Literal) {
+                auto literal = static_cast<ASTLiteral *>(name);
+                return literal->literalType == ASTLiteral::Type::Name ? literal->name : 0;
+            } else if (name->kind == ASTKind::BinaryOperator) {
+                auto binop = static_cast<ASTBinaryOperator *>(name);
 
-                    if (compareQualifiedNames(decl->name, decl2->name)) {
-                        return std::make_pair(true, decl2);
-                    }
-                }
+                core::Symbol left = nameKey(binop->left), right = nameKey(binop->right);
+                if (!left || !right) return 0;
+
+                auto &interner = core::Interner::global();
+                return interner.intern(fmt::format("{}::{}", interner.get(left), interner.get(right)));
             }
 
-            if (currentFunction) {
-                for (auto &paramDecl : currentFunction->paramDecls) {
-                    if (paramDecl->getType() == ASTType::VariableDeclaration) {
-                        auto decl2 = std::reinterpret_pointer_cast<ASTVariableDeclaration>(paramDecl);
+            return 0;
+        }
 
-                        if (compareQualifiedNames(decl->name, decl2->name)) {
-                            return std::make_pair(true, decl2);
-                        }
-                    }
+        ASTNode *Validator::declaredName(ASTNode *node) {
+            switch (node->kind) {
+                case ASTKind::FunctionHeader: return static_cast<ASTFunctionHeader *>(node)->name;
+                case ASTKind::VariableDeclaration: return static_cast<ASTVariableDeclaration *>(node)->name;
+                case ASTKind::VariableDefinition: return static_cast<ASTVariableDefinition *>(node)->decl->name;
+                default: return nullptr;
+            }
+        }
+
+        void Validator::declare(Scope &scope, ASTNode *node) {
+            if (auto name = declaredName(node)) {
+                if (core::Symbol key = nameKey(name)) {
+                    scope.emplace(key, node);
                 }
             }
+        }
 
-            return std::make_pair(false, std::shared_ptr<ASTVariableDeclaration> {});
+        parser::ASTRef *Validator::makeRef(ASTNode *node) {
+            auto result = module.make<ASTRef>(node);
+            result->evaluatedType = typeOf(node);
+
+            return result;
         }
 
-        bool Validator::isImplicitlyConvertible(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right) {
-            return false;
+        parser::ASTRef *Validator::findQualified(ASTNode *qlf) {
+            core::Symbol key = nameKey(qlf);
+            if (!key) return {};
+
+            auto node = resolve(key);
+            return node ? makeRef(node) : nullptr;
         }
 
-        bool Validator::compareTypes(const std::shared_ptr<Type> &left, const std::shared_ptr<Type> &right) {
-            if (left->decl->getTag() != right->decl->getTag()) return false;
-            if (left->getPointer() != right->getPointer()) return false;
-            // Eventually check if they're the same structure, enumeration, or union.
+        std::shared_ptr<Type> Validator::signatureOf(ASTFunctionHeader *function) {
+            if (!function->prototype) typer->typeFunction(function);
+            return function->prototype;
+        }
 
-            auto tag = left->decl->getTag();
+        std::shared_ptr<Type> Validator::typeOf(ASTNode *node) {
+            switch (node->kind) {
+                case ASTKind::FunctionHeader: return signatureOf(static_cast<ASTFunctionHeader *>(node));
+                case ASTKind::VariableDeclaration: return static_cast<ASTVariableDeclaration *>(node)->targetTy.evaluatedType;
+                case ASTKind::VariableDefinition: break;
+                default: return nullptr;
+            }
 
-            if (tag == TypeDeclaration::Tag::FunctionPrototype) {
-                FunctionPrototype &lpr = std::get<FunctionPrototype>(left->decl->info);
-                FunctionPrototype &rpr = std::get<FunctionPrototype>(right->decl->info);
+            auto defn = static_cast<ASTVariableDefinition *>(node);
 
-                if (!compareTypes(lpr.rt, rpr.rt)) {
-                    return false;
-                }
+            // A local is validated before anything can see it; a top-level variable may not have been yet.
+            if (declarations->variables.count(node)) {
+                auto it = declarations->outcomes.find(node);
 
-                if (lpr.paramTypes.size() != rpr.paramTypes.size()) {
-                    return false;
+                if (it == declarations->outcomes.end()) {
+                    validateOutOfOrder(node);
+                    it = declarations->outcomes.find(node);
+                } else if (!it->second.done) {
+                    throw core::Error(core::Error::Type::Semantic, defn->begin, defn->end, fmt::format("the value of '{}' depends on itself.", unqualifyName(defn->decl->name)));
                 }
 
-                auto npt = lpr.paramTypes.size();
-
-                for (std::size_t i = 0; i < npt; i++) {
-                    if (!compareTypes(lpr.paramTypes[i], rpr.paramTypes[i])) {
-                        return false;
-                    }
+                if (it->second.exception) {
+                    std::rethrow_exception(it->second.exception);
                 }
             }
 
-            return true;
+            return defn->decl->targetTy.evaluatedType;
         }
 
-        std::shared_ptr<parser::ASTRef> Validator::findQualified(const std::shared_ptr<ASTNode> &qlf) {
-            if (currentFunction) {
-                for (auto &pd : currentFunction->paramDecls) {
-                    if (compareQualifiedNames(pd->name, qlf)) {
-                        auto result = std::make_shared<ASTRef>(pd);
-                        result->evaluatedType = pd->targetTy.evaluatedType;
-                        return result;
-                    }
+        ASTNode *Validator::resolve(core::Symbol name) {
+            for (auto scope = scopes.rbegin(); scope != scopes.rend(); ++scope) {
+                if (auto it = scope->find(name); it != scope->end()) {
+                    return it->second;
                 }
             }
 
-            if (currentBlock) {
-                // Try to find variable in local scope
+            if (auto it = declarations->globals.find(name); it != declarations->globals.end()) {
+                depend(it->second);
+                return it->second;
+            }
 
-                for (auto &node : currentBlock->nodes) {
-                    if (node == currentStatement) break;
+            return nullptr;
+        }
 
-                    if (node->getType() == ASTType::VariableDeclaration) {
-                        auto decl = std::reinterpret_pointer_cast<ASTVariableDeclaration>(node);
-                        auto name = decl->name;
+        const Validator::OverloadSet *Validator::overloadsOf(core::Symbol name) {
+            auto it = declarations->functions.find(name);
+            if (it == declarations->functions.end()) return nullptr;
 
-                        if (compareQualifiedNames(name, qlf)) {
-                            auto result = std::make_shared<ASTRef>(node);
-                            result->evaluatedType = decl->targetTy.evaluatedType;
-                            return result;
-                        }
-                    } else if (node->getType() == ASTType::VariableDefinition) {
-                        auto defn = std::reinterpret_pointer_cast<ASTVariableDefinition>(node);
-                        auto decl = defn->decl;
-                        auto name = decl->name;
-
-                        if (compareQualifiedNames(name, qlf)) {
-                            auto result = std::make_shared<ASTRef>(node);
-                            result->evaluatedType = decl->targetTy.evaluatedType;
-                            return result;
-                        }
-                    }
+            auto &overloads = it->second;
+            if (!overloads.indexed) {
+                for (auto function : overloads.declared) {
+                    auto &paramTypes = std::get<FunctionPrototype>(signatureOf(function)->decl->info).paramTypes;
+                    overloads.set[hashTypes(paramTypes)].push_back(function);
                 }
 
-                if (currentBlock->parent) {
-                    auto last = currentBlock;
-                    currentBlock = currentBlock->parent;
-                    auto lastStatement = currentStatement;
-                    currentStatement = currentBlock;
-                    auto result = findQualified(qlf);
-                    currentStatement = lastStatement;
-                    currentBlock = last;
-                    return result;
-                }
+                overloads.indexed = true;
             }
 
-            for (auto &node : nodes) {
-                if (node->getType() == ASTType::FunctionHeader) {
-                    auto function = std::reinterpret_pointer_cast<ASTFunctionHeader>(node);
-                    auto name = function->name;
-
-                    // We don't have global variables yet, but we will; I don't want to add this later...
-                    if (compareQualifiedNames(name, qlf)) {
-                        auto result = std::make_shared<ASTRef>(node);
-                        result->evaluatedType = function->prototype;
-                        return result;
-                    }
-                } else if (node->getType() == ASTType::VariableDeclaration) {
-                    auto decl = std::reinterpret_pointer_cast<ASTVariableDeclaration>(node);
-                    auto name = decl->name;
-
-                    if (compareQualifiedNames(name, qlf)) {
-                        auto result = std::make_shared<ASTRef>(node);
-                        result->evaluatedType = decl->targetTy.evaluatedType;
-                        return result;
-                    }
-                } else if (node->getType() == ASTType::VariableDefinition) {
-                    auto defn = std::reinterpret_pointer_cast<ASTVariableDefinition>(node);
-                    auto decl = defn->decl;
-                    auto name = decl->name;
-
-                    if (compareQualifiedNames(name, qlf)) {
-                        auto result = std::make_shared<ASTRef>(node);
-                        result->evaluatedType = decl->targetTy.evaluatedType;
-                        return result;
-                    }
-                }
-            }
+            return &overloads.set;
+        }
 
-            return {};
+        bool Validator::isTopLevel(ASTNode *node) {
+            return node->kind == ASTKind::FunctionHeader || declarations->variables.count(node);
         }
 
-        void Validator::validateFunction(const std::shared_ptr<ASTFunctionHeader> &function) {
+        void Validator::depend(ASTNode *node) {
+            if (!recordDependencies || !currentTopLevel || node == currentTopLevel || !isTopLevel(node)) return;
+
+            if (used.insert(node).second) {
+                dependencies[currentTopLevel].push_back(node);
+            }
+        }
+
+        void Validator::validateFunction(ASTFunctionHeader *function) {
             auto lastFunction = currentFunction;
             currentFunction = function;
 
-            typer->typeFunction(function);
+            signatureOf(function);
 
-            // Todo(Sean): Check for overloads
-            if (std::pair<bool, std::shared_ptr<ASTFunctionHeader>> result; (result = isRepeatFunctionDeclaration(function)).second) {
-                errors.emplace_back(core::Error::Type::Semantic, function->begin.source, function->begin, function->end, fmt::format("redeclaration of function '{}'; previous declaration occured at: {}:{}:{}.", unqualifyName(function->name), result.second->begin.moduleName, result.second->begin.line, result.second->begin.lexpos));
+            if (std::pair<bool, ASTFunctionHeader *> result; (result = isRepeatFunctionDeclaration(function)).second) {
+                errors.emplace_back(core::Error::Type::Semantic, function->begin, function->end, fmt::format("redeclaration of function '{}'; previous declaration occured at: {}.", unqualifyName(function->name), result.second->begin.getFormatted()));
                 return;
             }
 
             if ((function->flags & (std::uint32_t)ASTFunctionHeader::Flags::Foreign) && (function->flags & (std::uint32_t)ASTFunctionHeader::Flags::Extern)) {
-                errors.emplace_back(core::Error::Type::Semantic, function->begin.source, function->begin, function->end, "a function can't be external and foreign.");
+                errors.emplace_back(core::Error::Type::Semantic, function->begin, function->end, "a function can't be external and foreign.");
             }
 
             if ((function->flags & (std::uint32_t)ASTFunctionHeader::Flags::CCall) && (function->flags & (std::uint32_t)ASTFunctionHeader::Flags::FastCall)) {
-                errors.emplace_back(core::Error::Type::Semantic, function->begin.source, function->begin, function->end, "a function can't have multiple calling conventions.");
+                errors.emplace_back(core::Error::Type::Semantic, function->begin, function->end, "a function can't have multiple calling conventions.");
             }
 
             if (function->body) {
-                validateBlock(function->body->block);
+                // The body sees its parameters and none of the locals of whatever we were in the middle of.
+                auto lastScopes = std::move(scopes);
+                scopes.clear();
+
+                Scope &params = scopes.emplace_back();
+                for (auto &paramDecl : function->paramDecls) {
+                    declare(params, paramDecl);
+                }
+
+                // The body may have been skimmed into a module other validators are allocating from too.
+                if (function->body->skimmed) function->body->skimmed = &module;
+
+                validateBlock(function->body->getBlock());
 
                 if (function->rt.evaluatedType->decl->getTag() != TypeDeclaration::Tag::None) {
                     // Find return statement;
 
-                    auto findret = [](const std::shared_ptr<ASTBlock> &block) {
+                    auto findret = [](ASTBlock *block) {
                         for (auto &node : block->nodes) {
                             if (node->getType() == ASTType::Return) {
                                 return true;
@@ -282,63 +298,71 @@ namespace rtl {
 
                     if (!findret(function->body->block)) {
                         auto last = function->body->block->nodes.back();
-                        errors.emplace_back(core::Error::Type::Semantic, last->begin.source, last->begin, last->end, fmt::format("expected return statement in function: '{}'.", unqualifyName(function->name)));
+                        errors.emplace_back(core::Error::Type::Semantic, last->begin, last->end, fmt::format("expected return statement in function: '{}'.", unqualifyName(function->name)));
                     }
                 }
+
+                scopes = std::move(lastScopes);
             }
 
             currentFunction = lastFunction;
         }
 
-        void Validator::validateBlock(const std::shared_ptr<ASTBlock> &block) {
+        void Validator::validateBlock(ASTBlock *block) {
             auto lastBlock = currentBlock;
             currentBlock = block;
 
+            scopes.emplace_back();
+
             for (auto &node : block->nodes) {
                 currentStatement = node;
                 validateNode(node);
+
+                declare(scopes.back(), node);
             }
 
+            scopes.pop_back();
+
             currentBlock = lastBlock;
         }
 
-        void Validator::validateVariableDeclaration(const std::shared_ptr<ASTVariableDeclaration> &decl) {
+        void Validator::validateVariableDeclaration(ASTVariableDeclaration *decl) {
             typer->typeVariableDeclaration(decl);
 
-            auto ourNone = std::make_shared<Type>(builtinTypes->noneType, 0);
+            auto ourNone = typeContext->get(builtinTypes->noneType, 0);
             if (decl->targetTy.evaluatedType->decl && compareTypes(decl->targetTy.evaluatedType, ourNone)) {
-                errors.emplace_back(core::Error::Type::Semantic, decl->begin.source, decl->begin, decl->end, "cannot declare variable of type 'none'.");
+                errors.emplace_back(core::Error::Type::Semantic, decl->begin, decl->end, "cannot declare variable of type 'none'.");
             }
 
-            if (std::pair<bool, std::shared_ptr<ASTVariableDeclaration>> result; (result = isRepeatDeclaration(decl)).second) {
-                errors.emplace_back(core::Error::Type::Semantic, decl->begin.source, decl->begin, decl->end, fmt::format("redeclaration of variable '{}'; previous declaration occurred at: {}:{}:{}.", unqualifyName(decl->name), result.second->begin.moduleName, result.second->begin.line, result.second->begin.lexpos));
+            if (std::pair<bool, ASTVariableDeclaration *> result; (result = isRepeatDeclaration(decl)).second) {
+                errors.emplace_back(core::Error::Type::Semantic, decl->begin, decl->end, fmt::format("redeclaration of variable '{}'; previous declaration occurred at: {}.", unqualifyName(decl->name), result.second->begin.getFormatted()));
             }
         }
 
-        void Validator::validateVariableDefinition(const std::shared_ptr<ASTVariableDefinition> &defn) {
+        void Validator::validateVariableDefinition(ASTVariableDefinition *defn) {
             validateVariableDeclaration(defn->decl);
-            defn->expr = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(defn->expr));
+            defn->expr = validateExpression(static_cast<ASTExpression *>(defn->expr));
 
-            if (!defn->decl->targetTy.evaluatedType || (defn->decl->targetTy.baseType->getType() == ASTType::BuiltinType && std::reinterpret_pointer_cast<ASTBuiltinType>(defn->decl->targetTy.baseType)->builtinType == ASTBuiltinType::Type::Auto)) {
-                defn->decl->targetTy.evaluatedType = std::reinterpret_pointer_cast<ASTExpression>(defn->expr)->evaluatedType;
+            if (!defn->decl->targetTy.evaluatedType || (defn->decl->targetTy.baseType->getType() == ASTType::BuiltinType && static_cast<ASTBuiltinType *>(defn->decl->targetTy.baseType)->builtinType == ASTBuiltinType::Type::Auto)) {
+                defn->decl->targetTy.evaluatedType = static_cast<ASTExpression *>(defn->expr)->evaluatedType;
             }
 
-            auto ourNone = std::make_shared<Type>(builtinTypes->noneType, 0);
+            auto ourNone = typeContext->get(builtinTypes->noneType, 0);
             if (compareTypes(defn->decl->targetTy.evaluatedType, ourNone)) {
-                errors.emplace_back(core::Error::Type::Semantic, defn->begin.source, defn->begin, defn->end, "cannot define variable of type 'none'.");
+                errors.emplace_back(core::Error::Type::Semantic, defn->begin, defn->end, "cannot define variable of type 'none'.");
             }
 
-            if (!compareTypes(defn->decl->targetTy.evaluatedType, std::reinterpret_pointer_cast<ASTExpression>(defn->expr)->evaluatedType)) {
-                errors.emplace_back(core::Error::Type::Semantic, defn->begin.source, defn->begin, defn->end, "assigned value doesn't match type of l-value.");
+            if (!compareTypes(defn->decl->targetTy.evaluatedType, static_cast<ASTExpression *>(defn->expr)->evaluatedType)) {
+                errors.emplace_back(core::Error::Type::Semantic, defn->begin, defn->end, "assigned value doesn't match type of l-value.");
             }
         }
 
-        void Validator::validateIf(const std::shared_ptr<ASTIf> &ifStatement) {
-            ifStatement->condition = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(ifStatement->condition));
+        void Validator::validateIf(ASTIf *ifStatement) {
+            ifStatement->condition = validateExpression(static_cast<ASTExpression *>(ifStatement->condition));
             validateNode(ifStatement->statement);
 
             for (auto &[condition, statement] : ifStatement->elifs) {
-                validateExpression(std::reinterpret_pointer_cast<ASTExpression>(condition));
+                validateExpression(static_cast<ASTExpression *>(condition));
                 validateNode(statement);
             }
 
@@ -347,93 +371,95 @@ namespace rtl {
             }
         }
 
-        void Validator::validateFor(const std::shared_ptr<ASTFor> &forStatement) {
+        void Validator::validateFor(ASTFor *forStatement) {
             auto lastFor = currentFor;
             currentFor = forStatement;
 
-            validateRange(std::reinterpret_pointer_cast<ASTRange>(forStatement->expr));
+            validateRange(static_cast<ASTRange *>(forStatement->expr));
             validateNode(forStatement->statement);
 
             currentFor = lastFor;
         }
 
-        void Validator::validateRange(const std::shared_ptr<ASTRange> &range) {
-            range->lower = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(range->lower));
-            range->upper = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(range->upper));
+        void Validator::validateRange(ASTRange *range) {
+            range->lower = validateExpression(static_cast<ASTExpression *>(range->lower));
+            range->upper = validateExpression(static_cast<ASTExpression *>(range->upper));
 
             auto isRangable = [](const std::shared_ptr<Type> &ty) {
                 return ty->decl->getTag() != TypeDeclaration::Tag::Bool && ty->decl->getTag() != TypeDeclaration::Tag::Structure && ty->decl->getTag() != TypeDeclaration::Tag::Union &&  ty->decl->getTag() != TypeDeclaration::Tag::Enumeration;
             };
 
-            if (!isRangable(std::reinterpret_pointer_cast<ASTExpression>(range->lower)->evaluatedType)) {
-                errors.emplace_back(core::Error::Type::Semantic, range->lower->begin.source, range->lower->begin, range->lower->end, "value is not of rangable type.");
+            if (!isRangable(static_cast<ASTExpression *>(range->lower)->evaluatedType)) {
+                errors.emplace_back(core::Error::Type::Semantic, range->lower->begin, range->lower->end, "value is not of rangable type.");
             }
 
-            if (!isRangable(std::reinterpret_pointer_cast<ASTExpression>(range->upper)->evaluatedType)) {
-                errors.emplace_back(core::Error::Type::Semantic, range->upper->begin.source, range->upper->begin, range->upper->end, "value is not of rangable type.");
+            if (!isRangable(static_cast<ASTExpression *>(range->upper)->evaluatedType)) {
+                errors.emplace_back(core::Error::Type::Semantic, range->upper->begin, range->upper->end, "value is not of rangable type.");
             }
         }
 
-        void Validator::validateWhile(const std::shared_ptr<ASTWhile> &whileStatement) {
+        void Validator::validateWhile(ASTWhile *whileStatement) {
             auto lastWhile = currentWhile;
             currentWhile = whileStatement;
 
-            whileStatement->condition = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(whileStatement->condition));
+            if (whileStatement->condition) { // `while { ... }` loops forever.
+                whileStatement->condition = validateExpression(static_cast<ASTExpression *>(whileStatement->condition));
+            }
             validateNode(whileStatement->statement);
 
             currentWhile = lastWhile;
         }
 
-        void Validator::validateContinue(const std::shared_ptr<ASTContinue> &continueStatement) {
+        void Validator::validateContinue(ASTContinue *continueStatement) {
             if (!currentFor && !currentWhile) {
-                errors.emplace_back(core::Error::Type::Semantic, continueStatement->begin.source, continueStatement->begin, continueStatement->end, "continue is only valid in loops.");
+                errors.emplace_back(core::Error::Type::Semantic, continueStatement->begin, continueStatement->end, "continue is only valid in loops.");
             }
         }
 
-        void Validator::validateBreak(const std::shared_ptr<ASTBreak> &breakStatement) {
+        void Validator::validateBreak(ASTBreak *breakStatement) {
             if (!currentFor && !currentWhile) {
-                errors.emplace_back(core::Error::Type::Semantic, breakStatement->begin.source, breakStatement->begin, breakStatement->end, "break is only valid in loops.");
+                errors.emplace_back(core::Error::Type::Semantic, breakStatement->begin, breakStatement->end, "break is only valid in loops.");
             }
         }
 
-        void Validator::validateReturn(const std::shared_ptr<ASTReturn> &returnStatement) {
-            returnStatement->expr = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(returnStatement->expr));
+        void Validator::validateReturn(ASTReturn *returnStatement) {
+            returnStatement->expr = validateExpression(static_cast<ASTExpression *>(returnStatement->expr));
 
-            if (!compareTypes(std::reinterpret_pointer_cast<ASTExpression>(returnStatement->expr)->evaluatedType, currentFunction->rt.evaluatedType)) {
-                errors.emplace_back(core::Error::Type::Semantic, returnStatement->begin.source, returnStatement->begin, returnStatement->end, fmt::format("return value does not match return type of function: '{}'.", unqualifyName(currentFunction->name)));
+            if (!compareTypes(static_cast<ASTExpression *>(returnStatement->expr)->evaluatedType, currentFunction->rt.evaluatedType)) {
+                errors.emplace_back(core::Error::Type::Semantic, returnStatement->begin, returnStatement->end, fmt::format("return value does not match return type of function: '{}'.", unqualifyName(currentFunction->name)));
             }
         }
 
-        std::shared_ptr<ASTNode> Validator::validateExpression(const std::shared_ptr<ASTExpression> &expr) {
+        ASTNode *Validator::validateExpression(ASTExpression *expr) {
             auto result = expr;
 
             using Ty = ASTExpression::Type;
             if (expr->getExprType() == Ty::BinaryOperator) {
-                auto binop = std::reinterpret_pointer_cast<ASTBinaryOperator>(expr);
+                auto binop = static_cast<ASTBinaryOperator *>(expr);
 
-                auto lhs = std::reinterpret_pointer_cast<ASTExpression>(binop->left);
+                auto lhs = static_cast<ASTExpression *>(binop->left);
                 auto lty = lhs->getExprType();
 
-                auto rhs = std::reinterpret_pointer_cast<ASTExpression>(binop->right);
+                auto rhs = static_cast<ASTExpression *>(binop->right);
                 auto rty = rhs->getExprType();
 
                 if (binop->binopType == ASTBinaryOperator::Type::MemberResolution) {
-                    if ((lty == ASTExpression::Type::BinaryOperator && std::reinterpret_pointer_cast<ASTBinaryOperator>(lhs)->binopType != ASTBinaryOperator::Type::NamespaceResolution) || lty != ASTExpression::Type::Literal) {
-                        errors.emplace_back(core::Error::Type::Semantic, lhs->begin.source, lhs->begin, lhs->end, "expected left-hand operand of type name or namespace resolution.");
+                    if ((lty == ASTExpression::Type::BinaryOperator && static_cast<ASTBinaryOperator *>(lhs)->binopType != ASTBinaryOperator::Type::NamespaceResolution) || lty != ASTExpression::Type::Literal) {
+                        errors.emplace_back(core::Error::Type::Semantic, lhs->begin, lhs->end, "expected left-hand operand of type name or namespace resolution.");
                     } else if (lty == ASTExpression::Type::Literal) {
-                        auto lit = std::reinterpret_pointer_cast<ASTLiteral>(lhs);
+                        auto lit = static_cast<ASTLiteral *>(lhs);
                         if (lit->literalType != ASTLiteral::Type::Name) {
-                            errors.emplace_back(core::Error::Type::Semantic, lhs->begin.source, lhs->begin, lhs->end, "expected left-hand operand of type name.");
+                            errors.emplace_back(core::Error::Type::Semantic, lhs->begin, lhs->end, "expected left-hand operand of type name.");
                         }
                     }
 
                     if (rty == ASTExpression::Type::Literal) {
-                        auto lit = std::reinterpret_pointer_cast<ASTLiteral>(lhs);
+                        auto lit = static_cast<ASTLiteral *>(lhs);
                         if (lit->literalType != ASTLiteral::Type::Name) {
-                            errors.emplace_back(core::Error::Type::Semantic, rhs->begin.source, rhs->begin, rhs->end, "expected right-hand operand of type name.");
+                            errors.emplace_back(core::Error::Type::Semantic, rhs->begin, rhs->end, "expected right-hand operand of type name.");
                         }
                     } else {
-                        errors.emplace_back(core::Error::Type::Semantic, rhs->begin.source, rhs->begin, rhs->end, "expected right-hand operand of type name.");
+                        errors.emplace_back(core::Error::Type::Semantic, rhs->begin, rhs->end, "expected right-hand operand of type name.");
                     }
                 }
 
@@ -442,13 +468,13 @@ namespace rtl {
                     auto node = findQualified(binop); // Find qualified global or local otherwise error.
 
                     if (!node) {
-                        throw core::Error(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, fmt::format("undeclared reference to '{}'.", unqualifyName(binop)));
+                        throw core::Error(core::Error::Type::Semantic, binop->begin, binop->end, fmt::format("undeclared reference to '{}'.", unqualifyName(binop)));
                     }
 
                     return node;
                 } else {
-                    binop->left = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(binop->left));
-                    binop->right = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(binop->right));
+                    binop->left = validateExpression(static_cast<ASTExpression *>(binop->left));
+                    binop->right = validateExpression(static_cast<ASTExpression *>(binop->right));
                 }
 
                 if (!expr->evaluatedType) typer->typeExpression(expr);
@@ -456,195 +482,108 @@ namespace rtl {
                 if (binop->binopType == ASTBinaryOperator::Type::Assign) {
                     auto lhs = binop->left;
                     if (lhs->getType() == ASTType::Expression) {
-                        auto expr = std::reinterpret_pointer_cast<ASTExpression>(lhs);
+                        auto expr = static_cast<ASTExpression *>(lhs);
 
                         if (expr->getExprType() == ASTExpression::Type::Ref) {
-                            auto ref = std::reinterpret_pointer_cast<ASTRef>(expr);
+                            auto ref = static_cast<ASTRef *>(expr);
                             auto node = ref->node;
 
-                            if (node->getType() == ASTType::VariableDeclaration && (std::reinterpret_pointer_cast<ASTVariableDeclaration>(node)->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant)) {
-                                errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "cannot assign to constant data.");
-                            } else if (node->getType() == ASTType::VariableDefinition && (std::reinterpret_pointer_cast<ASTVariableDefinition>(node)->decl->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant)) {
-                                errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "cannot assign to constant data.");
+                            if (node->getType() == ASTType::VariableDeclaration && (static_cast<ASTVariableDeclaration *>(node)->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant)) {
+                                errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "cannot assign to constant data.");
+                            } else if (node->getType() == ASTType::VariableDefinition && (static_cast<ASTVariableDefinition *>(node)->decl->flags & (std::uint32_t)ASTVariableDeclaration::Flags::Constant)) {
+                                errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "cannot assign to constant data.");
                             } else if (node->getType() != ASTType::VariableDeclaration && node->getType() != ASTType::VariableDefinition) {
-                                errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
+                                errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
                             }
                         } else {
-                            errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
+                            errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
                         }
                     } else {
-                        errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
+                        errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "left-hand operand must be a valid l-value.");
                     }
 
                 }
 
-                if (!compareTypes(std::reinterpret_pointer_cast<ASTExpression>(binop->left)->evaluatedType, std::reinterpret_pointer_cast<ASTExpression>(binop->right)->evaluatedType)) {
-                    errors.emplace_back(core::Error::Type::Semantic, binop->begin.source, binop->begin, binop->end, "cannot implicitly convert types between left and right expressions."); // Todo(Sean): Make this error message show the actual name of the type.
+                if (!compareTypes(static_cast<ASTExpression *>(binop->left)->evaluatedType, static_cast<ASTExpression *>(binop->right)->evaluatedType)) {
+                    errors.emplace_back(core::Error::Type::Semantic, binop->begin, binop->end, "cannot implicitly convert types between left and right expressions."); // Todo(Sean): Make this error message show the actual name of the type.
                 }
             } else if (expr->getExprType() == Ty::UnaryOperator) {
-                auto unop = std::reinterpret_pointer_cast<ASTUnaryOperator>(expr);
+                auto unop = static_cast<ASTUnaryOperator *>(expr);
 
-                unop->node = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(unop->node));
+                unop->node = validateExpression(static_cast<ASTExpression *>(unop->node));
             } else if (expr->getExprType() == Ty::Call) {
-                auto call = std::reinterpret_pointer_cast<ASTCall>(expr);
+                auto call = static_cast<ASTCall *>(expr);
 
-                bool found = false;
-
-                auto compareNode = [&](const std::shared_ptr<ASTNode> &node) {
-                    if (node->getType() == ASTType::FunctionHeader) {
-                        auto function = std::reinterpret_pointer_cast<ASTFunctionHeader>(node);
-
-                        if (!function->prototype) {
-                            validateFunction(function);
-                        }
+                for (auto &arg : call->callArgs) {
+                    arg = validateExpression(static_cast<ASTExpression *>(arg));
+                }
 
-                        if (compareQualifiedNames(function->name, call->called)) {
-                            // Todo(Sean): Check for Variadic Arguments here eventually
-                            bool failed = false;
-                            if (call->callArgs.size() == function->paramDecls.size()) {
-
-                                for (std::size_t i = 0; i < call->callArgs.size(); i++) {
-                                    auto callArg = call->callArgs[i] = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(call->callArgs[i]));
-                                    auto paramDecl = function->paramDecls[i];
-
-                                    std::shared_ptr<Type> callArgTy;
-
-                                    if (callArg->getType() == ASTType::Expression) {
-                                        callArgTy = std::reinterpret_pointer_cast<ASTExpression>(callArg)->evaluatedType;
-                                    } else if (callArg->getType() == ASTType::VariableDeclaration) {
-                                        callArgTy = std::reinterpret_pointer_cast<ASTVariableDeclaration>(callArg)->targetTy.evaluatedType;
-                                    } else if (callArg->getType() == ASTType::VariableDefinition) {
-                                        callArgTy = std::reinterpret_pointer_cast<ASTVariableDefinition>(callArg)->decl->targetTy.evaluatedType;
-                                    } else {
-                                        errors.emplace_back(core::Error::Type::Semantic, callArg->begin.source, callArg->begin, callArg->end, "unsupported call param.");
-                                        callArgTy = std::make_shared<Type>(builtinTypes->noneType, 0);
-                                    }
-
-                                    if (!compareTypes(callArgTy, paramDecl->targetTy.evaluatedType)) {
-                                        failed = true;
-                                        break;
-                                    }
-                                }
-                            } else {
-                                failed = true;
-                            }
+                core::Symbol key = nameKey(call->called);
+                ASTNode *callee {};
 
-                            if (!failed) {
-                                call->called = function;
-                                found = true;
-                            }
-                        }
-                    } else if (node->getType() == ASTType::VariableDeclaration || node->getType() == ASTType::VariableDefinition) {
-                        std::shared_ptr<ASTVariableDeclaration> decl;
+                // A local or a parameter hides every function of the same name.
+                for (auto scope = scopes.rbegin(); scope != scopes.rend() && !callee; ++scope) {
+                    if (auto it = scope->find(key); it != scope->end()) {
+                        callee = it->second;
+                    }
+                }
 
-                        if (node->getType() == ASTType::VariableDefinition) {
-                            auto defn = std::reinterpret_pointer_cast<ASTVariableDefinition>(node);
-                            decl = defn->decl;
+                if (!callee) {
+                    if (declarations->functions.count(key)) {
+                        // Todo(Sean): Check for Variadic Arguments here eventually
+                        std::vector<std::shared_ptr<Type>> argTypes;
+                        argTypes.reserve(call->callArgs.size());
 
-                            if (!defn->decl->targetTy.evaluatedType) validateVariableDefinition(defn);
-                        } else {
-                            decl = std::reinterpret_pointer_cast<ASTVariableDeclaration>(node);
+                        for (auto &arg : call->callArgs) {
+                            argTypes.push_back(getArgumentType(arg));
                         }
 
-                        if (compareQualifiedNames(decl->name, call->called)) {
-                            if (!decl->targetTy.evaluatedType) validateVariableDeclaration(decl);
-                            call->called = decl;
-
-                            if (decl->targetTy.evaluatedType->decl->getTag() != TypeDeclaration::Tag::FunctionPrototype) {
-                                throw core::Error(core::Error::Type::Semantic, call->begin.source, call->begin, call->end, fmt::format("'{}' is not callable.", unqualifyName(call->called)));
-                            }
-
-                            bool valargs = false;
-
-                            if (call->callArgs.size() != std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes.size()) {
-                                errors.emplace_back(core::Error::Type::Semantic, call->begin.source, call->begin, call->end, fmt::format("function prototype: '{}' expects {} argument{}, but was given {}.", unqualifyName(std::reinterpret_pointer_cast<ASTVariableDeclaration>(call->called)->name), std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes.size(), std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes.size() > 1 ? "s" : "", call->callArgs.size()));
+                        callee = findOverload(key, argTypes);
+                    } else if (auto it = declarations->globals.find(key); it != declarations->globals.end()) {
+                        callee = it->second;
+                    }
 
-                                valargs = true; // We validate the arguments here because there might be more arguments in the call than there are in the prototype declaration.
+                    if (callee) depend(callee);
+                }
 
-                                for (auto &arg : call->callArgs) {
-                                    arg = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(arg));
-                                }
-                            }
+                if (callee && callee->kind == ASTKind::FunctionHeader) {
+                    call->called = callee;
+                } else if (callee) {
+                    typeOf(callee);
 
-                            auto count = std::min(call->callArgs.size(), std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes.size());
-                            for (std::size_t i = 0; i < count; i++) {
-                                if (!valargs) call->callArgs[i] = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(call->callArgs[i]));
-                                auto callArg = call->callArgs[i];
-                                auto paramType = std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes[i];
-
-                                std::shared_ptr<Type> callArgTy;
-
-                                if (callArg->getType() == ASTType::Expression) {
-                                    callArgTy = std::reinterpret_pointer_cast<ASTExpression>(callArg)->evaluatedType;
-                                } else if (callArg->getType() == ASTType::VariableDeclaration) {
-                                    callArgTy = std::reinterpret_pointer_cast<ASTVariableDeclaration>(callArg)->targetTy.evaluatedType;
-                                } else if (callArg->getType() == ASTType::VariableDefinition) {
-                                    callArgTy = std::reinterpret_pointer_cast<ASTVariableDefinition>(callArg)->decl->targetTy.evaluatedType;
-                                } else {
-                                    errors.emplace_back(core::Error::Type::Semantic, callArg->begin.source, callArg->begin, callArg->end, "unsupported call param.");
-                                    callArgTy = std::make_shared<Type>(builtinTypes->noneType, 0);
-                                }
-
-                                if (!compareTypes(callArgTy, paramType)) {
-                                    errors.emplace_back(core::Error::Type::Semantic, callArg->begin.source, callArg->begin, callArg->end, "argument type mismatch in function prototype invokation.");
-                                }
-                            }
+                    auto decl = callee->kind == ASTKind::VariableDefinition ? static_cast<ASTVariableDefinition *>(callee)->decl : static_cast<ASTVariableDeclaration *>(callee);
+                    call->called = decl;
 
-                            found = true;
-                        }
+                    if (decl->targetTy.evaluatedType->decl->getTag() != TypeDeclaration::Tag::FunctionPrototype) {
+                        throw core::Error(core::Error::Type::Semantic, call->begin, call->end, fmt::format("'{}' is not callable.", unqualifyName(decl->name)));
                     }
 
-                    return found;
-                };
+                    auto &paramTypes = std::get<FunctionPrototype>(decl->targetTy.evaluatedType->decl->info).paramTypes;
 
-                if (currentFunction) {
-                    for (auto &pd : currentFunction->paramDecls) {
-                        if (compareNode(pd)) break;
+                    if (call->callArgs.size() != paramTypes.size()) {
+                        errors.emplace_back(core::Error::Type::Semantic, call->begin, call->end, fmt::format("function prototype: '{}' expects {} argument{}, but was given {}.", unqualifyName(decl->name), paramTypes.size(), paramTypes.size() > 1 ? "s" : "", call->callArgs.size()));
                     }
-                }
 
-                if (!found && currentBlock) {
-                    auto lastStatement = currentStatement;
-                    for (auto block = currentBlock; block; block = currentBlock->parent) {
-                        for (auto &node : block->nodes) {
-                            currentStatement = node;
-                            if (compareNode(node)) break;
-                        }
-                    }
-                    currentStatement = lastStatement;
-                }
+                    auto count = std::min(call->callArgs.size(), paramTypes.size());
+                    for (std::size_t i = 0; i < count; i++) {
+                        auto callArg = call->callArgs[i];
 
-                if (!found) {
-                    for (auto &node : nodes) {
-                        if (compareNode(node)) break;
-                    }
-                }
-
-                if (!found) {
-                    std::shared_ptr<ASTNode> name;
-
-                    if (call->called->getType() == ASTType::FunctionHeader) {
-                        name = std::reinterpret_pointer_cast<ASTFunctionHeader>(call->called)->name;
-                    } else if (call->called->getType() == ASTType::VariableDeclaration) {
-                        name = std::reinterpret_pointer_cast<ASTFunctionHeader>(call->called)->name;
-                    } else if (call->called->getType() == ASTType::Expression) {
-                        auto expr = std::reinterpret_pointer_cast<ASTExpression>(call->called);
-                        if (expr->getExprType() == ASTExpression::Type::Literal) {
-                            name = std::reinterpret_pointer_cast<ASTLiteral>(expr);
+                        if (!compareTypes(getArgumentType(callArg), paramTypes[i])) {
+                            errors.emplace_back(core::Error::Type::Semantic, callArg->begin, callArg->end, "argument type mismatch in function prototype invokation.");
                         }
                     }
-
-                    errors.emplace_back(core::Error::Type::Semantic, call->begin.source, call->begin, call->end, fmt::format("no matching declaration to call of '{}'.", unqualifyName(name)));
-                    call->evaluatedType = std::make_shared<Type>(builtinTypes->noneType, 0);
+                } else {
+                    errors.emplace_back(core::Error::Type::Semantic, call->begin, call->end, fmt::format("no matching declaration to call of '{}'.", unqualifyName(call->called)));
+                    call->evaluatedType = typeContext->get(builtinTypes->noneType, 0);
                 }
             } else if (expr->getExprType() == Ty::Literal) {
-                auto lit = std::reinterpret_pointer_cast<ASTLiteral>(expr);
+                auto lit = static_cast<ASTLiteral *>(expr);
 
                 if (lit->literalType == ASTLiteral::Type::Name) {
                     auto node = findQualified(lit); // Find qualified global or local otherwise error.
 
                     if (!node) {
-                        throw core::Error(core::Error::Type::Semantic, lit->begin.source, lit->begin, lit->end, fmt::format("undeclared reference to '{}'.", unqualifyName(lit)));
+                        throw core::Error(core::Error::Type::Semantic, lit->begin, lit->end, fmt::format("undeclared reference to '{}'.", unqualifyName(lit)));
                     }
 
                     return node;
@@ -660,75 +599,240 @@ namespace rtl {
             return result;
         }
 
-        void Validator::validateNode(std::shared_ptr<ASTNode> &node) {
-            using Ty = ASTType;
-            switch (node->getType()) {
-                case Ty::FunctionHeader: {
-                    validateFunction(std::reinterpret_pointer_cast<ASTFunctionHeader>(node));
-                    break;
-                }
+        ASTNode *Validator::visitNode(ASTNode *node) {
+            return node;
+        }
 
-                case Ty::Block: {
-                    validateBlock(std::reinterpret_pointer_cast<ASTBlock>(node));
-                    break;
-                }
+        ASTNode *Validator::visitFunctionHeader(ASTFunctionHeader *header) {
+            validateFunction(header);
+            return header;
+        }
 
-                case Ty::VariableDeclaration: {
-                    validateVariableDeclaration(std::reinterpret_pointer_cast<ASTVariableDeclaration>(node));
-                    break;
-                }
+        ASTNode *Validator::visitBlock(ASTBlock *block) {
+            validateBlock(block);
+            return block;
+        }
 
-                case Ty::VariableDefinition: {
-                    validateVariableDefinition(std::reinterpret_pointer_cast<ASTVariableDefinition>(node));
-                    break;
-                }
+        ASTNode *Validator::visitVariableDeclaration(ASTVariableDeclaration *decl) {
+            validateVariableDeclaration(decl);
+            return decl;
+        }
 
-                case Ty::If: {
-                    validateIf(std::reinterpret_pointer_cast<ASTIf>(node));
-                    break;
-                }
+        ASTNode *Validator::visitVariableDefinition(ASTVariableDefinition *defn) {
+            validateVariableDefinition(defn);
+            return defn;
+        }
 
-                case Ty::For: {
-                    validateFor(std::reinterpret_pointer_cast<ASTFor>(node));
-                    break;
-                }
+        ASTNode *Validator::visitIf(ASTIf *ifStatement) {
+            validateIf(ifStatement);
+            return ifStatement;
+        }
 
-                case Ty::Range: {
-                    validateRange(std::reinterpret_pointer_cast<ASTRange>(node));
-                    break;
-                }
+        ASTNode *Validator::visitFor(ASTFor *forStatement) {
+            validateFor(forStatement);
+            return forStatement;
+        }
 
-                case Ty::While: {
-                    validateWhile(std::reinterpret_pointer_cast<ASTWhile>(node));
-                    break;
+        ASTNode *Validator::visitRange(ASTRange *range) {
+            validateRange(range);
+            return range;
+        }
+
+        ASTNode *Validator::visitWhile(ASTWhile *whileStatement) {
+            validateWhile(whileStatement);
+            return whileStatement;
+        }
+
+        ASTNode *Validator::visitContinue(ASTContinue *continueStatement) {
+            validateContinue(continueStatement);
+            return continueStatement;
+        }
+
+        ASTNode *Validator::visitBreak(ASTBreak *breakStatement) {
+            validateBreak(breakStatement);
+            return breakStatement;
+        }
+
+        ASTNode *Validator::visitReturn(ASTReturn *returnStatement) {
+            validateReturn(returnStatement);
+            return returnStatement;
+        }
+
+        ASTNode *Validator::visitExpression(ASTExpression *expr) {
+            return validateExpression(expr);
+        }
+
+        void Validator::validateNode(ASTNode *&node) {
+            node = visit(node);
+        }
+
+        void Validator::indexDeclarations(bool typed) {
+            declarations->functions.reserve(nodes.size());
+
+            for (auto &node : nodes) {
+                declare(declarations->globals, node);
+
+                if (node->kind == ASTKind::FunctionHeader) {
+                    auto function = static_cast<ASTFunctionHeader *>(node);
+                    auto &overloads = declarations->functions[nameKey(function->name)];
+
+                    if (typed) {
+                        auto &paramTypes = std::get<FunctionPrototype>(signatureOf(function)->decl->info).paramTypes;
+                        overloads.set[hashTypes(paramTypes)].push_back(function);
+                        overloads.indexed = true;
+                    } else {
+                        overloads.declared.push_back(function);
+                    }
+                } else if (node->kind == ASTKind::VariableDefinition) {
+                    declarations->variables.insert(node);
                 }
+            }
+        }
+
+        void Validator::validateOutOfOrder(ASTNode *node) {
+            auto &outcome = declarations->outcomes[node];
+
+            auto lastTopLevel = currentTopLevel;
+            auto lastUsed = std::move(used);
+            currentTopLevel = node;
+            used.clear();
+
+            // A variable's initializer sees none of the locals of the body that asked for its type.
+            auto lastScopes = std::move(scopes);
+            scopes.clear();
+
+            auto mark = errors.size();
 
-                case Ty::Continue: {
-                    validateContinue(std::reinterpret_pointer_cast<ASTContinue>(node));
-                    break;
+            try {
+                ASTNode *validated = node;
+                validateNode(validated);
+            } catch (...) {
+                outcome.exception = std::current_exception();
+            }
+
+            outcome.errors.assign(std::make_move_iterator(errors.begin() + mark), std::make_move_iterator(errors.end()));
+            errors.erase(errors.begin() + mark, errors.end());
+            outcome.done = true;
+
+            scopes = std::move(lastScopes);
+            currentTopLevel = lastTopLevel;
+            used = std::move(lastUsed);
+        }
+
+        bool Validator::replay(ASTNode *node) {
+            auto it = declarations->outcomes.find(node);
+            if (it == declarations->outcomes.end()) return false;
+
+            errors.insert(errors.end(), it->second.errors.begin(), it->second.errors.end());
+
+            if (it->second.exception) {
+                std::rethrow_exception(it->second.exception);
+            }
+
+            return true;
+        }
+
+        void Validator::collectDeclarations() {
+            // Type every signature up front, so that a call can be resolved against a function defined further down without the bodies writing to 'declarations'.
+            indexDeclarations(true);
+
+            // Any body may use a top-level variable, so they're all validated before the bodies are; that also means the bodies never write to 'declarations'.
+            for (auto &node : nodes) {
+                if (node->kind != ASTKind::VariableDefinition) continue;
+
+                try {
+                    typeOf(node);
+                } catch (...) {
+                    // Kept in its Outcome until validate() gets to it.
                 }
+            }
+        }
+
+        void Validator::validate(std::size_t begin, std::size_t end) {
+            if (recordDependencies) {
+                dependencies.reserve(dependencies.size() + (end - begin));
+            }
+
+            for (std::size_t i = begin; i < end; i++) {
+                if (replay(nodes[i])) continue;
+
+                currentTopLevel = nodes[i];
+                used.clear();
+                validateNode(nodes[i]);
+            }
+
+            currentTopLevel = nullptr;
+            used.clear();
+        }
+
+        void Validator::validate() {
+            collectDeclarations();
+            validate(0, nodes.size());
+        }
 
-                case Ty::Break: {
-                    validateBreak(std::reinterpret_pointer_cast<ASTBreak>(node));
-                    break;
+        void Validator::validateReachable(core::Symbol root) {
+            std::vector<ASTNode *> work;
+
+            for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+                if ((*it)->kind == ASTKind::FunctionHeader && nameKey(static_cast<ASTFunctionHeader *>(*it)->name) == root) {
+                    work.push_back(*it);
                 }
+            }
+
+            if (work.empty()) {
+                validate();
+                return;
+            }
 
-                case Ty::Return: {
-                    validateReturn(std::reinterpret_pointer_cast<ASTReturn>(node));
-                    break;
+            indexDeclarations(false);
+            recordDependencies = true;
+
+            std::unordered_set<ASTNode *> seen(work.begin(), work.end());
+
+            while (!work.empty()) {
+                auto node = work.back();
+                work.pop_back();
+
+                if (node->kind == ASTKind::VariableDefinition) {
+                    try {
+                        typeOf(node);
+                    } catch (...) {
+                        // Kept in its Outcome.
+                    }
+                } else {
+                    if (!declarations->outcomes.count(node)) {
+                        validateOutOfOrder(node);
+                    }
+
+                    // Every function of the same name is checked too, or a redeclaration of one that's used would go unreported.
+                    auto &functions = declarations->functions[nameKey(static_cast<ASTFunctionHeader *>(node)->name)].declared;
+                    for (auto function = functions.rbegin(); function != functions.rend(); ++function) {
+                        if (seen.insert(*function).second) {
+                            work.push_back(*function);
+                        }
+                    }
                 }
 
-                case Ty::Expression: {
-                    node = validateExpression(std::reinterpret_pointer_cast<ASTExpression>(node));
-                    break;
+                if (auto it = dependencies.find(node); it != dependencies.end()) {
+                    for (auto use = it->second.rbegin(); use != it->second.rend(); ++use) {
+                        if (seen.insert(*use).second) {
+                            work.push_back(*use);
+                        }
+                    }
                 }
             }
-        }
 
-        void Validator::validate() {
             for (auto &node : nodes) {
-                validateNode(node);
+                replay(node);
             }
         }
+
+        void Validator::setRecordDependencies(bool record) {
+            recordDependencies = record;
+        }
+
+        Validator::Dependencies Validator::takeDependencies() {
+            return std::move(dependencies);
+        }
     }
-}
\ No newline at end of file
+}